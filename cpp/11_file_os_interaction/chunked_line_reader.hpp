@@ -0,0 +1,196 @@
+// chunked_line_reader.hpp
+// ChunkedLineReader: reads a file line by line through one reusable buffer
+// and returns each line as a std::string_view.
+//
+//   ChunkedLineReader in("\r\n");
+//   if (!in.open("data.txt")) { perror("open"); return 1; }
+//   std::string_view line;
+//   while (in.next(line)) use(line);       // line is valid until the next call
+//   if (in.error() != 0) { errno = in.error(); perror("read"); }
+//
+// The delimiter can be any non-empty byte string: "\n", "\r\n", "\x1e"
+// (ASCII record separator), "\n--\n"... It is not part of the returned line.
+// As with std::getline, a last line without delimiter is still returned, and
+// a file that ends with the delimiter has no extra empty line at the end.
+//
+// The buffer starts at chunk_bytes and is refilled with read(). Before a
+// refill the unfinished line moves to the front of the buffer; the buffer
+// only grows (doubling) when one line no longer fits. Memory is therefore
+// bounded by about twice the longest line (and at least chunk_bytes), no
+// matter how many lines the file has, and a line costs no allocation.
+//
+// Searching for the delimiter:
+// - one byte: memchr(), which the C library implements with SIMD
+// - longer: 16 positions at a time with SSE2, comparing the first and last
+//   delimiter byte at every position and checking the middle bytes only
+//   where both match; a portable memchr() + memcmp() loop elsewhere
+// Bytes already searched are not searched again after a refill.
+//
+// Errors are reported like the other readers here: next() returns false,
+// and error() holds the errno of the failed read (0 at a normal end).
+
+#ifndef CHUNKED_LINE_READER_HPP
+#define CHUNKED_LINE_READER_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// First occurrence of d in [p, p + n), or nullptr. d must not be empty.
+inline const char* find_delimiter(const char* p, std::size_t n, std::string_view d) {
+    const std::size_t k = d.size();
+    if (k == 1) return static_cast<const char*>(std::memchr(p, d[0], n));
+    if (n < k) return nullptr;
+    std::size_t i = 0;
+#if defined(__SSE2__)
+    const __m128i first = _mm_set1_epi8(d[0]);
+    const __m128i last = _mm_set1_epi8(d[k - 1]);
+    for (; i + k - 1 + 16 <= n; i += 16) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i + k - 1));
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+        while (mask != 0) {
+            const unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            if (std::memcmp(p + i + bit + 1, d.data() + 1, k - 2) == 0) return p + i + bit;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    while (i + k <= n) {
+        const char* c = static_cast<const char*>(std::memchr(p + i, d[0], n - k + 1 - i));
+        if (c == nullptr) return nullptr;
+        if (std::memcmp(c + 1, d.data() + 1, k - 1) == 0) return c;
+        i = static_cast<std::size_t>(c - p) + 1;
+    }
+    return nullptr;
+}
+
+class ChunkedLineReader {
+public:
+    explicit ChunkedLineReader(std::string delimiter = "\n", std::size_t chunk_bytes = 64 * 1024)
+        : delim_(delimiter.empty() ? std::string("\n") : std::move(delimiter)),
+          chunk_(std::max(chunk_bytes, delim_.size())) {}
+    ~ChunkedLineReader() { close(); }
+    ChunkedLineReader(const ChunkedLineReader&) = delete;
+    ChunkedLineReader& operator=(const ChunkedLineReader&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) return false;
+        owns_fd_ = true;
+        reset();
+        return true;
+    }
+
+    // Reads from an already open descriptor (a pipe, stdin...), not closed here.
+    void attach(int fd) {
+        close();
+        fd_ = fd;
+        owns_fd_ = false;
+        reset();
+    }
+
+    void close() {
+        if (owns_fd_ && fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+        owns_fd_ = false;
+    }
+
+    // The next line, without its delimiter; false at the end or on error.
+    bool next(std::string_view& line) {
+        if (fd_ < 0) return false;
+        const std::size_t k = delim_.size();
+        for (;;) {
+            if (const char* hit = find_delimiter(buf_.get() + scan_, end_ - scan_, delim_)) {
+                const std::size_t at = static_cast<std::size_t>(hit - buf_.get());
+                line = std::string_view(buf_.get() + begin_, at - begin_);
+                begin_ = scan_ = at + k;
+                ++lines_;
+                return true;
+            }
+            if (eof_) {
+                if (begin_ == end_) return false;
+                line = std::string_view(buf_.get() + begin_, end_ - begin_);
+                begin_ = scan_ = end_;
+                ++lines_;
+                return true;
+            }
+            // The last k - 1 bytes may be the start of a delimiter.
+            scan_ = std::max(begin_, end_ >= k - 1 ? end_ - (k - 1) : 0);
+            if (!refill()) return false;
+        }
+    }
+
+    int error() const { return error_; }
+    std::size_t lines() const { return lines_; }
+    std::size_t capacity() const { return cap_; }
+    const std::string& delimiter() const { return delim_; }
+
+private:
+    std::string delim_;
+    std::size_t chunk_;
+    int fd_ = -1;
+    bool owns_fd_ = false;
+    std::unique_ptr<char[]> buf_;
+    std::size_t cap_ = 0;
+    std::size_t begin_ = 0;  // start of the current (unfinished) line
+    std::size_t scan_ = 0;   // searched up to here
+    std::size_t end_ = 0;    // end of the data read so far
+    bool eof_ = false;
+    int error_ = 0;
+    std::size_t lines_ = 0;
+
+    void reset() {
+        if (cap_ < chunk_) {
+            buf_.reset(new char[chunk_]);
+            cap_ = chunk_;
+        }
+        begin_ = scan_ = end_ = 0;
+        eof_ = false;
+        error_ = 0;
+        lines_ = 0;
+    }
+
+    // Moves the unfinished line to the front, grows the buffer if the line
+    // fills it, and reads more.
+    bool refill() {
+        if (begin_ > 0) {
+            std::memmove(buf_.get(), buf_.get() + begin_, end_ - begin_);
+            end_ -= begin_;
+            scan_ -= begin_;
+            begin_ = 0;
+        }
+        if (cap_ - end_ < std::max<std::size_t>(chunk_ / 2, 1)) {  // never read() into 0 bytes
+            const std::size_t cap = std::max(cap_ * 2, end_ + chunk_);
+            std::unique_ptr<char[]> bigger(new char[cap]);
+            std::memcpy(bigger.get(), buf_.get(), end_);
+            buf_ = std::move(bigger);
+            cap_ = cap;
+        }
+        for (;;) {
+            ssize_t r = ::read(fd_, buf_.get() + end_, cap_ - end_);
+            if (r < 0 && errno == EINTR) continue;
+            if (r < 0) {
+                error_ = errno;
+                return false;
+            }
+            if (r == 0) eof_ = true;
+            end_ += static_cast<std::size_t>(r);
+            return true;
+        }
+    }
+};
+
+#endif // CHUNKED_LINE_READER_HPP
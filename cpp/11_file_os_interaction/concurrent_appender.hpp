@@ -0,0 +1,434 @@
+// concurrent_appender.hpp
+// ConcurrentAppender: many threads append whole lines to one file; one
+// writer thread turns them into large O_APPEND writes.
+//
+//   ConcurrentAppender log;                      // default Options
+//   if (!log.open("app.log")) { perror("open"); return 1; }
+//   // from any thread:
+//   log.append("worker 3 finished job 17");      // a '\n' is added
+//   log.close();                                 // drains and joins
+//
+// Producers never take a lock. The ring is an array of 64-byte slots with a
+// sequence number each (the bounded queue of Dmitry Vyukov). A line takes
+// as many consecutive slots as it needs: the producer claims them with one
+// compare-and-swap on the head position, copies the line in, and publishes
+// it by storing the sequence number of its first slot. The writer thread
+// takes lines in position order, copies them into a batch buffer and hands
+// the buffer to write() when it is full or when the oldest line in it has
+// waited flush_interval.
+//
+// Per-line atomicity: a line is copied whole into the batch buffer, so one
+// write() never carries part of a line (a line longer than the batch gets a
+// write() of its own). With O_APPEND each write() lands at the end of the
+// file in one piece, even with other processes appending too.
+//
+// Lines of one thread keep their order. When the ring is full, append()
+// either waits for the writer (block_when_full) or drops the line and
+// returns false with errno EAGAIN. A line longer than the ring is refused
+// with EMSGSIZE. Before open(), and once close() has started, append()
+// returns false with EBADF; close() waits for appends already in progress,
+// so every line append() accepted reaches the file.
+//
+// With measure_latency, append() records its own duration in a log2
+// histogram (sharded by thread, so the counters are not a hot spot).
+
+#ifndef CONCURRENT_APPENDER_HPP
+#define CONCURRENT_APPENDER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Counts of durations in power-of-two buckets: bucket b holds [2^b, 2^(b+1)) ns.
+struct LatencyHistogram {
+    static constexpr int buckets = 40;
+    std::uint64_t count[buckets] = {};
+
+    static int bucket_of(std::uint64_t ns) {
+        int b = 0;
+        while (ns > 1 && b < buckets - 1) {
+            ns >>= 1;
+            ++b;
+        }
+        return b;
+    }
+    void add(std::uint64_t ns) { ++count[bucket_of(ns)]; }
+    std::uint64_t total() const {
+        std::uint64_t t = 0;
+        for (std::uint64_t c : count) t += c;
+        return t;
+    }
+    // Upper bound of the bucket holding quantile q (0..1), in ns.
+    std::uint64_t percentile(double q) const {
+        const std::uint64_t n = total();
+        std::uint64_t seen = 0;
+        for (int b = 0; b < buckets; ++b) {
+            seen += count[b];
+            if (n > 0 && seen >= q * n) return std::uint64_t(2) << b;
+        }
+        return 0;
+    }
+};
+
+class ConcurrentAppender {
+public:
+    struct Options {
+        std::size_t ring_slots = 1 << 16;  // rounded up to a power of two; 52 bytes of line each
+        std::size_t batch_bytes = 1 << 20;
+        std::chrono::microseconds flush_interval{5000};
+        bool block_when_full = true;
+        bool measure_latency = true;
+    };
+
+    struct Stats {
+        std::uint64_t lines = 0;     // written
+        std::uint64_t bytes = 0;
+        std::uint64_t writes = 0;    // write() calls
+        std::uint64_t dropped = 0;   // refused because the ring was full
+        std::uint64_t waits = 0;     // times a producer found the ring full and waited
+    };
+
+    ConcurrentAppender() : ConcurrentAppender(Options()) {}
+    explicit ConcurrentAppender(Options opt) : opt_(opt) {
+        std::size_t slots = 2;
+        while (slots < opt_.ring_slots) slots *= 2;
+        mask_ = slots - 1;
+        ring_.reset(new Slot[slots]);
+    }
+    ~ConcurrentAppender() { close(); }
+    ConcurrentAppender(const ConcurrentAppender&) = delete;
+    ConcurrentAppender& operator=(const ConcurrentAppender&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        fd_ = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+        if (fd_ < 0) return false;
+        for (std::size_t i = 0; i <= mask_; ++i) ring_[i].seq.store(i, std::memory_order_relaxed);
+        head_.store(0, std::memory_order_relaxed);
+        tail_ = 0;
+        written_.store(0, std::memory_order_relaxed);
+        error_.store(0, std::memory_order_relaxed);
+        flush_target_.store(0, std::memory_order_relaxed);
+        stopping_.store(false, std::memory_order_relaxed);
+        stats_ = Stats{};
+        dropped_.store(0, std::memory_order_relaxed);
+        waits_.store(0, std::memory_order_relaxed);
+        for (Shard& s : shards_)
+            for (auto& c : s.count) c.store(0, std::memory_order_relaxed);
+        writer_ = std::thread([this] { run(); });
+        accepting_.store(true);
+        return true;
+    }
+
+    // Writes everything appended so far, stops the writer thread.
+    bool close() {
+        if (fd_ < 0) return true;
+        // No new appends; the writer stops only once those in flight are done.
+        accepting_.store(false);
+        for (const Shard& s : shards_)
+            while (s.appending.load() != 0) std::this_thread::yield();
+        stopping_.store(true);
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            writer_cv_.notify_one();
+        }
+        writer_.join();
+        bool ok = error_.load() == 0;
+        ok = (::close(fd_) == 0) && ok;
+        fd_ = -1;
+        return ok;
+    }
+
+    // Appends line + '\n'. Thread-safe and lock-free unless the ring is full.
+    bool append(std::string_view line) {
+        // Pairs with close(): either close() sees this append in flight and
+        // waits for it, or this append sees that close() has started.
+        Shard& mine = shard();
+        mine.appending.fetch_add(1);
+        if (!accepting_.load()) {
+            mine.appending.fetch_sub(1);
+            errno = EBADF;
+            return false;
+        }
+        const auto t0 = opt_.measure_latency ? Clock::now() : Clock::time_point();
+        const bool ok = push(line);
+        if (opt_.measure_latency) {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+            mine.count[LatencyHistogram::bucket_of(static_cast<std::uint64_t>(ns))].fetch_add(
+                1, std::memory_order_relaxed);
+        }
+        mine.appending.fetch_sub(1, std::memory_order_release);
+        return ok;
+    }
+
+    // Returns once every line appended before the call has been written.
+    bool flush() {
+        const std::uint64_t target = head_.load(std::memory_order_acquire);
+        std::uint64_t cur = flush_target_.load();
+        while (cur < target && !flush_target_.compare_exchange_weak(cur, target)) {
+        }
+        std::unique_lock<std::mutex> lock(m_);
+        writer_cv_.notify_one();
+        flushed_cv_.wait(lock, [&] {
+            return written_.load(std::memory_order_acquire) >= target || error_.load() != 0;
+        });
+        if (error_.load() != 0) {
+            errno = error_.load();
+            return false;
+        }
+        return true;
+    }
+
+    // Exact after close() or flush(); approximate while producers run.
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock(m_);
+        Stats s = stats_;
+        s.dropped = dropped_.load(std::memory_order_relaxed);
+        s.waits = waits_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+    LatencyHistogram latency() const {
+        LatencyHistogram h;
+        for (const Shard& s : shards_)
+            for (int b = 0; b < LatencyHistogram::buckets; ++b)
+                h.count[b] += s.count[b].load(std::memory_order_relaxed);
+        return h;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t slot_payload = 52;
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> seq{0};  // == position: free; == position + 1: holds a line
+        std::uint32_t len = 0;              // line bytes, in the first slot of a line
+        char data[slot_payload];
+    };
+    static_assert(sizeof(Slot) == 64, "one slot per cache line");
+
+    struct alignas(64) Shard {
+        std::atomic<std::uint64_t> count[LatencyHistogram::buckets];
+        std::atomic<std::int64_t> appending{0};  // append() calls in progress
+    };
+    static constexpr std::size_t shard_count = 16;
+
+    Options opt_;
+    std::unique_ptr<Slot[]> ring_;
+    std::size_t mask_ = 0;
+    int fd_ = -1;
+
+    alignas(64) std::atomic<std::uint64_t> head_{0};     // next position to claim
+    alignas(64) std::uint64_t tail_ = 0;                  // writer thread only
+    std::atomic<std::uint64_t> written_{0};               // positions below are in the file
+    std::atomic<int> error_{0};
+    std::atomic<bool> accepting_{false};                  // open and not closing
+    std::atomic<bool> stopping_{false};
+    std::atomic<std::uint64_t> flush_target_{0};          // flush() waits for written_ to reach it
+    std::atomic<bool> writer_idle_{false};
+    std::atomic<int> producers_waiting_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    std::atomic<std::uint64_t> waits_{0};
+    Shard shards_[shard_count];
+
+    mutable std::mutex m_;
+    std::condition_variable writer_cv_;   // lines arrived, flush or close requested
+    std::condition_variable space_cv_;    // slots were freed
+    std::condition_variable flushed_cv_;  // written_ advanced
+    Stats stats_;                         // guarded by m_
+    std::thread writer_;
+
+    static std::size_t slots_for(std::size_t bytes) {
+        return std::max<std::size_t>((bytes + slot_payload - 1) / slot_payload, 1);
+    }
+
+    Shard& shard() {
+        static std::atomic<std::size_t> next{0};
+        thread_local std::size_t mine = next.fetch_add(1, std::memory_order_relaxed);
+        return shards_[mine % shard_count];
+    }
+
+    void wake_writer() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (writer_idle_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(m_);
+            writer_cv_.notify_one();
+        }
+    }
+
+    bool push(std::string_view line) {
+        const std::size_t len = line.size() + 1;
+        const std::size_t k = slots_for(len);
+        if (k > mask_ + 1 || len > UINT32_MAX) {
+            errno = EMSGSIZE;
+            return false;
+        }
+        std::uint64_t pos = head_.load(std::memory_order_relaxed);
+        bool waited = false;
+        for (;;) {
+            // Slots are freed in order, so the last one being free means all are.
+            const std::uint64_t last = pos + k - 1;
+            const std::uint64_t seq = ring_[last & mask_].seq.load(std::memory_order_acquire);
+            const std::int64_t diff = static_cast<std::int64_t>(seq - last);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + k, std::memory_order_relaxed)) break;
+            } else if (diff < 0) {
+                if (!opt_.block_when_full) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    errno = EAGAIN;
+                    return false;
+                }
+                if (!waited) waits_.fetch_add(1, std::memory_order_relaxed);
+                waited = true;
+                wait_for_space(last);
+                pos = head_.load(std::memory_order_relaxed);
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Copy the line (and its '\n') into slots pos .. pos + k - 1.
+        std::size_t done = 0;
+        for (std::size_t j = 0; j < k; ++j) {
+            Slot& s = ring_[(pos + j) & mask_];
+            const std::size_t n = std::min(slot_payload, len - done);
+            const std::size_t from_line = std::min(n, line.size() > done ? line.size() - done : 0);
+            std::memcpy(s.data, line.data() + done, from_line);
+            if (from_line < n) s.data[from_line] = '\n';
+            done += n;
+        }
+        Slot& first = ring_[pos & mask_];
+        first.len = static_cast<std::uint32_t>(len);
+        first.seq.store(pos + 1, std::memory_order_release);  // publish
+        wake_writer();
+        return true;
+    }
+
+    void wait_for_space(std::uint64_t last) {
+        producers_waiting_.fetch_add(1);
+        std::unique_lock<std::mutex> lock(m_);
+        space_cv_.wait_for(lock, std::chrono::microseconds(200), [&] {
+            return static_cast<std::int64_t>(ring_[last & mask_].seq.load(std::memory_order_acquire) - last) >= 0 ||
+                   stopping_.load();
+        });
+        producers_waiting_.fetch_sub(1);
+    }
+
+    // ------------------------------------------------------------------
+    // Writer thread
+    // ------------------------------------------------------------------
+    void run() {
+        std::vector<char> batch;
+        batch.reserve(opt_.batch_bytes);
+        std::uint64_t batch_lines = 0;
+        Clock::time_point oldest{};  // arrival of the first line in batch
+        for (;;) {
+            // Take every published line, in order.
+            bool took = false;
+            for (;;) {
+                Slot& s = ring_[tail_ & mask_];
+                if (s.seq.load(std::memory_order_acquire) != tail_ + 1) break;
+                const std::size_t len = s.len, k = slots_for(len);
+                if (!batch.empty() && batch.size() + len > opt_.batch_bytes) write_batch(batch, batch_lines);
+                if (batch.empty()) oldest = Clock::now();
+                std::size_t done = 0;
+                for (std::size_t j = 0; j < k; ++j) {
+                    Slot& p = ring_[(tail_ + j) & mask_];
+                    const std::size_t n = std::min(slot_payload, len - done);
+                    batch.insert(batch.end(), p.data, p.data + n);
+                    done += n;
+                }
+                for (std::size_t j = 0; j < k; ++j)
+                    ring_[(tail_ + j) & mask_].seq.store(tail_ + j + mask_ + 1, std::memory_order_release);
+                tail_ += k;
+                ++batch_lines;
+                took = true;
+                if (batch.size() >= opt_.batch_bytes) write_batch(batch, batch_lines);
+            }
+            if (took) {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (producers_waiting_.load(std::memory_order_relaxed) > 0) {
+                    std::lock_guard<std::mutex> lock(m_);
+                    space_cv_.notify_all();
+                }
+            }
+
+            const bool stop = stopping_.load();
+            const bool flush = flush_target_.load() > written_.load(std::memory_order_relaxed);
+            if (!batch.empty() && (stop || flush || Clock::now() - oldest >= opt_.flush_interval))
+                write_batch(batch, batch_lines);
+            if (batch.empty()) publish_written();
+            if (stop && head_.load() == tail_) {
+                publish_written();
+                return;
+            }
+            if (took) continue;
+
+            // Nothing ready: sleep until a producer wakes us or the batch is due.
+            // Producers notify under m_, so checking the ring in the predicate
+            // cannot miss a line published just before the wait.
+            writer_idle_.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(m_);
+                auto due = batch.empty() ? opt_.flush_interval
+                                         : std::chrono::duration_cast<std::chrono::microseconds>(
+                                               opt_.flush_interval - (Clock::now() - oldest));
+                writer_cv_.wait_for(lock, std::max(due, std::chrono::microseconds(1)), [&] {
+                    return ring_[tail_ & mask_].seq.load(std::memory_order_acquire) == tail_ + 1 ||
+                           stopping_.load() ||
+                           (!batch.empty() && flush_target_.load() > written_.load(std::memory_order_relaxed));
+                });
+            }
+            writer_idle_.store(false);
+        }
+    }
+
+    void write_batch(std::vector<char>& batch, std::uint64_t& lines) {
+        const char* p = batch.data();
+        std::size_t left = batch.size();
+        std::uint64_t calls = 0;
+        while (left > 0 && error_.load(std::memory_order_relaxed) == 0) {
+            ssize_t w = ::write(fd_, p, left);
+            if (w < 0 && errno == EINTR) continue;
+            if (w <= 0) {
+                error_.store(w < 0 ? errno : EIO);
+                break;
+            }
+            ++calls;
+            p += w;
+            left -= static_cast<std::size_t>(w);
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            stats_.lines += lines;
+            stats_.bytes += batch.size();
+            stats_.writes += calls;
+        }
+        batch.clear();
+        lines = 0;
+    }
+
+    // Everything taken from the ring so far is in the file.
+    void publish_written() {
+        if (written_.load(std::memory_order_relaxed) == tail_) return;
+        std::lock_guard<std::mutex> lock(m_);
+        written_.store(tail_, std::memory_order_release);
+        flushed_cv_.notify_all();
+    }
+};
+
+#endif // CONCURRENT_APPENDER_HPP
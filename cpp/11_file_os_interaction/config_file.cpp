@@ -0,0 +1,206 @@
+// config_file.cpp
+// Complete C++17 tutorial and demo: a memory-mapped key=value config parser
+// with typed getters and minimal-perfect-hash lookup
+// Compile: g++ -std=c++17 -Wall -Wextra -O2 config_file.cpp -o config_file
+// Run: ./config_file
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "config_file.hpp"
+
+/*
+File_IO/TxtfileIo.cpp reads its two numbers from lines 1 and 3 of a text
+file with getline + stoi: insert a line and it reads the wrong value, and a
+typo throws std::invalid_argument from stoi. Named settings fix that:
+
+    number1 = 6
+    number2 = 7
+
+ConfigFile (config_file.hpp) maps the file, parses it in one pass into
+string_views and builds a minimal perfect hash over the keys. This demo:
+
+1. Parses a small config with sections, quotes and comments, and reads it
+   with the typed getters
+2. Shows how syntax errors are reported
+3. Generates a config with 200000 keys and compares load time and lookup
+   time with getline + std::unordered_map<std::string, std::string>,
+   counting heap allocations (operator new is replaced below)
+
+Interesting facts & pitfalls:
+- Values are views into the mapping: they dangle after close() or when the
+  ConfigFile is destroyed. Copy what you keep (std::string(value)).
+- Editing the file while it is mapped may change the values under you
+  (MAP_PRIVATE only isolates your own writes). Configs are usually
+  replaced with rename(), which leaves the old mapping intact.
+- The perfect hash only knows the keys it was built from: every unknown key
+  still lands on some slot, so find() always compares the key itself.
+- unordered_map::find() in C++17 wants a std::string, so a string_view or
+  char* key is copied (and a key longer than the small-string buffer
+  allocated) on every lookup; C++20 heterogeneous lookup avoids that.
+*/
+
+// --------------------------------------------------------------------
+// Counting allocations
+// --------------------------------------------------------------------
+static std::size_t g_allocations = 0;
+
+void* operator new(std::size_t n) {
+    ++g_allocations;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void* operator new[](std::size_t n) { return operator new(n); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+using Clock = std::chrono::steady_clock;
+
+template <class F>
+double ms(F f) {
+    auto t0 = Clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// What TxtfileIo.cpp would do with named settings: getline, split at '='.
+std::unordered_map<std::string, std::string> load_with_getline(const std::string& path) {
+    std::unordered_map<std::string, std::string> m;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        const std::size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        m[line.substr(0, eq - 1)] = line.substr(eq + 2);
+    }
+    return m;
+}
+
+int main() {
+    // --------------------------------------------------------------------
+    // 1. A small config
+    // --------------------------------------------------------------------
+    std::cout << "=== Step 1: service.conf ===\n";
+    const std::string path = "service.conf";
+    {
+        std::ofstream out(path, std::ios::trunc);
+        out << "# numbers for TxtfileIo\n"
+               "number1 = 6\n"
+               "number2 = 7\n"
+               "\n"
+               "[http]\n"
+               "port    = 8080\n"
+               "root    = /var/www   # document root\n"
+               "banner  = \"  hello, world  \"\n"
+               "gzip    = on\n"
+               "\n"
+               "[limits]\n"
+               "timeout_s = 2.5\n"
+               "max_body  = 1048576\n"
+               "max_body  = 4194304 ; the last one wins\n";
+    }
+    ConfigFile cfg;
+    if (!cfg.open(path)) {
+        std::perror(path.c_str());
+        return 1;
+    }
+    const int n1 = cfg.get_or("number1", 0), n2 = cfg.get_or("number2", 0);
+    bool gzip = false;
+    double timeout = 0;
+    long long max_body = 0;
+    bool ok = cfg.get("http.gzip", gzip) && cfg.get("limits.timeout_s", timeout) &&
+              cfg.get("limits.max_body", max_body);
+    std::cout << cfg.size() << " settings\n"
+              << "number1 * number2 = " << n1 * n2 << "\n"
+              << "http.port = " << cfg.get_or("http.port", 80) << ", root = " << cfg.get("http.root")
+              << ", banner = [" << cfg.get("http.banner") << "], gzip = " << std::boolalpha << gzip << "\n"
+              << "limits.timeout_s = " << timeout << ", limits.max_body = " << max_body << "\n"
+              << "missing key: [" << cfg.get_or("http.missing", "default") << "], port as bool parses: "
+              << cfg.get("http.port", gzip) << "\n\n";
+    ok = ok && n1 * n2 == 42 && max_body == 4194304 && cfg.get("http.banner") == "  hello, world  " &&
+         cfg.get("http.root") == "/var/www";
+
+    // --------------------------------------------------------------------
+    // 2. Syntax errors
+    // --------------------------------------------------------------------
+    std::cout << "=== Step 2: Syntax errors ===\n";
+    for (const char* text : {"a = 1\nb 2\n", "a = 1\n[http\nport = 1\n", "a = \"open\n", " = 5\n"}) {
+        ConfigFile bad;
+        const bool parsed = bad.parse(text);
+        std::cout << (parsed ? "parsed?! " : "error on line ") << bad.error_line() << "\n";
+        ok = ok && !parsed && errno == EINVAL;
+    }
+    std::cout << "\n";
+
+    // --------------------------------------------------------------------
+    // 3. A large config
+    // --------------------------------------------------------------------
+    const std::size_t n = 200000;
+    std::cout << "=== Step 3: " << n << " keys ===\n";
+    const std::string big_path = "big.conf";
+    std::vector<std::string> keys;
+    {
+        std::ofstream out(big_path, std::ios::trunc);
+        for (std::size_t i = 0; i < n; ++i) {
+            keys.push_back("service.shard" + std::to_string(i % 97) + ".setting_" + std::to_string(i));
+            out << keys.back() << " = " << i * 7 << "\n";
+        }
+    }
+    std::unordered_map<std::string, std::string> map;
+    std::size_t allocs = g_allocations;
+    const double map_load = ms([&] { map = load_with_getline(big_path); });
+    const std::size_t map_load_allocs = g_allocations - allocs;
+
+    ConfigFile big;
+    allocs = g_allocations;
+    const double cfg_load = ms([&] { ok = big.open(big_path) && ok; });
+    const std::size_t cfg_load_allocs = g_allocations - allocs;
+
+    // Hot path: the caller holds keys as string_views (say, from a request).
+    std::vector<std::string_view> lookups;
+    for (std::size_t i = 0; i < n; ++i) lookups.push_back(keys[(i * 7919) % n]);
+    const int rounds = 10;
+    long long map_sum = 0, cfg_sum = 0;
+    allocs = g_allocations;
+    const double map_find = ms([&] {
+        for (int r = 0; r < rounds; ++r)
+            for (std::string_view k : lookups) {
+                auto it = map.find(std::string(k));
+                if (it != map.end()) map_sum += it->second.size();
+            }
+    });
+    const std::size_t map_find_allocs = g_allocations - allocs;
+    allocs = g_allocations;
+    const double cfg_find = ms([&] {
+        for (int r = 0; r < rounds; ++r)
+            for (std::string_view k : lookups) cfg_sum += big.get(k).size();
+    });
+    const std::size_t cfg_find_allocs = g_allocations - allocs;
+    const double lookups_done = double(rounds) * n;
+
+    std::printf("load:   getline + unordered_map %7.1f ms, %7zu allocations\n", map_load, map_load_allocs);
+    std::printf("        ConfigFile              %7.1f ms, %7zu allocations\n", cfg_load, cfg_load_allocs);
+    std::printf("lookup: unordered_map::find     %7.1f ns, %.2f allocations per lookup\n",
+                map_find * 1e6 / lookups_done, map_find_allocs / lookups_done);
+    std::printf("        ConfigFile::get         %7.1f ns, %.2f allocations per lookup\n",
+                cfg_find * 1e6 / lookups_done, cfg_find_allocs / lookups_done);
+    long long v = -1;
+    ok = ok && big.size() == n && map_sum == cfg_sum && big.get(keys[12345], v) && v == 12345 * 7 &&
+         !big.contains("service.shard1.setting_x");
+    std::cout << (ok ? "same values\n" : "VALUES DIFFER!\n");
+
+    std::remove(path.c_str());
+    std::remove(big_path.c_str());
+    return ok ? 0 : 1;
+}
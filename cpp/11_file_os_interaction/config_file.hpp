@@ -0,0 +1,408 @@
+// config_file.hpp
+// ConfigFile: maps a key=value config file, parses it in one pass into
+// string_views and looks keys up through a minimal perfect hash.
+//
+//   ConfigFile cfg;
+//   if (!cfg.open("server.conf")) {
+//       if (errno == EINVAL) std::cerr << "syntax error on line " << cfg.error_line() << "\n";
+//       return 1;
+//   }
+//   int port = cfg.get_or("http.port", 8080);
+//   std::string_view root = cfg.get("http.root", "/var/www");
+//
+// Syntax, one setting per line:
+//   # comment            ; comment
+//   key = value          whitespace around key and value is dropped
+//   key = "  value "     quotes keep the spaces (no escape sequences)
+//   key = value # note   '#' or ';' after whitespace ends an unquoted value
+//   [http]               later keys are looked up as "http.key"
+// A key set twice keeps its last value. Anything else (a line without '=',
+// an empty key, an unterminated "[" or '"') fails open() with errno EINVAL,
+// and error_line() tells where.
+//
+// Keys and values are views into the mapping, which stays alive as long as
+// the ConfigFile: no string is copied, except keys inside a [section],
+// whose "section.key" form is built once into one buffer.
+//
+// Lookup: after parsing, the keys are placed into a table of exactly n
+// slots with "hash and displace". Every key has one 64-bit hash; its high
+// bits pick a bucket, and the bucket stores either the slot directly (when
+// it holds one key) or a seed that sends all of its keys to distinct slots.
+// get() therefore costs one hash of the key, one bucket load, one slot load
+// and one comparison, with no probing and no allocation.
+
+#ifndef CONFIG_FILE_HPP
+#define CONFIG_FILE_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class ConfigFile {
+public:
+    struct Entry {
+        std::string_view key;
+        std::string_view value;
+    };
+
+    ConfigFile() = default;
+    ~ConfigFile() { close(); }
+    ConfigFile(const ConfigFile&) = delete;
+    ConfigFile& operator=(const ConfigFile&) = delete;
+
+    // Maps and parses the file. errno is EINVAL on a syntax error.
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        bytes_ = static_cast<std::size_t>(st.st_size);
+        if (bytes_ > 0) {  // mmap refuses length 0
+            void* p = ::mmap(nullptr, bytes_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                bytes_ = 0;
+                return false;
+            }
+            map_ = static_cast<const char*>(p);
+            ::madvise(p, bytes_, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+        if (!parse_and_index(std::string_view(map_, bytes_))) {
+            const int e = errno;
+            const std::size_t line = error_line_;
+            close();
+            error_line_ = line;
+            errno = e;
+            return false;
+        }
+        return true;
+    }
+
+    // Parses text that the caller keeps alive (a string literal, a buffer...).
+    bool parse(std::string_view text) {
+        close();
+        return parse_and_index(text);
+    }
+
+    void close() {
+        if (map_ != nullptr) ::munmap(const_cast<char*>(map_), bytes_);
+        map_ = nullptr;
+        bytes_ = 0;
+        error_line_ = 0;
+        slots_.clear();
+        buckets_.clear();
+        section_keys_.clear();
+    }
+
+    std::size_t size() const { return slots_.size(); }
+    std::size_t error_line() const { return error_line_; }  // 1-based; 0 if none
+    const std::vector<Entry>& entries() const { return slots_; }  // in table order
+
+    const Entry* find(std::string_view key) const {
+        if (slots_.empty()) return nullptr;
+        const std::uint64_t h = hash(key, seed_);
+        const std::int32_t b = buckets_[range(h >> 32, buckets_.size())];
+        const std::size_t s = b < 0 ? static_cast<std::size_t>(-b - 1) : range(displace(h, b), slots_.size());
+        const Entry& e = slots_[s];
+        return e.key.size() == key.size() && std::memcmp(e.key.data(), key.data(), key.size()) == 0 ? &e
+                                                                                                     : nullptr;
+    }
+
+    bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+    std::string_view get(std::string_view key, std::string_view fallback = {}) const {
+        const Entry* e = find(key);
+        return e != nullptr ? e->value : fallback;
+    }
+
+    // Typed lookup: false if the key is missing or the value does not parse
+    // completely as T (integers and floating point via std::from_chars;
+    // bool from true/false, yes/no, on/off, 1/0). Not for const T, so that
+    // get(key, "fallback") still picks the string_view overload.
+    template <class T, class = std::enable_if_t<!std::is_const_v<T>>>
+    bool get(std::string_view key, T& out) const {
+        const Entry* e = find(key);
+        return e != nullptr && convert(e->value, out);
+    }
+
+    template <class T>
+    T get_or(std::string_view key, T fallback) const {
+        T v;
+        return get(key, v) ? v : fallback;
+    }
+    std::string_view get_or(std::string_view key, const char* fallback) const {
+        return get(key, std::string_view(fallback));
+    }
+
+    static bool convert(std::string_view s, std::string_view& out) {
+        out = s;
+        return true;
+    }
+    static bool convert(std::string_view s, bool& out) {
+        static constexpr std::string_view yes[] = {"true", "yes", "on", "1"}, no[] = {"false", "no", "off", "0"};
+        for (std::string_view w : yes)
+            if (s == w) {
+                out = true;
+                return true;
+            }
+        for (std::string_view w : no)
+            if (s == w) {
+                out = false;
+                return true;
+            }
+        return false;
+    }
+    template <class T>
+    static std::enable_if_t<std::is_arithmetic_v<T>, bool> convert(std::string_view s, T& out) {
+        const char* first = s.data();
+        if (s.size() > 1 && s[0] == '+' && s[1] != '-') ++first;  // from_chars does not take '+'
+        const auto r = std::from_chars(first, s.data() + s.size(), out);
+        return r.ec == std::errc() && r.ptr == s.data() + s.size() && first != r.ptr;
+    }
+
+private:
+    const char* map_ = nullptr;
+    std::size_t bytes_ = 0;
+    std::size_t error_line_ = 0;
+    std::uint64_t seed_ = 0;
+    std::vector<Entry> slots_;              // the perfect hash table, n entries
+    std::vector<std::int32_t> buckets_;     // < 0: -(slot) - 1; >= 0: seed for displace()
+    std::string section_keys_;              // "section.key" strings
+
+    // ------------------------------------------------------------------
+    // Hashing
+    // ------------------------------------------------------------------
+    static std::uint64_t mix(std::uint64_t x) {  // MurmurHash3 finalizer
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        return x ^ (x >> 33);
+    }
+
+    // Eight bytes at a time; the tail is zero-padded and the length mixed in.
+    static std::uint64_t hash(std::string_view key, std::uint64_t seed) {
+        std::uint64_t h = seed ^ (key.size() * 0x9e3779b97f4a7c15ULL);
+        const char* p = key.data();
+        std::size_t n = key.size();
+        for (; n >= 8; p += 8, n -= 8) {
+            std::uint64_t w;
+            std::memcpy(&w, p, 8);
+            h = (h ^ mix(w)) * 0x9e3779b97f4a7c15ULL;
+        }
+        if (n > 0) {
+            std::uint64_t w = 0;
+            std::memcpy(&w, p, n);
+            h = (h ^ mix(w)) * 0x9e3779b97f4a7c15ULL;
+        }
+        return mix(h);
+    }
+
+    static std::uint64_t displace(std::uint64_t h, std::int32_t seed) {
+        return mix(h + static_cast<std::uint64_t>(seed) * 0xbf58476d1ce4e5b9ULL);
+    }
+
+    // Maps 32 random bits to [0, n) with a multiply instead of a division.
+    static std::size_t range(std::uint64_t bits, std::size_t n) {
+        return static_cast<std::size_t>(((bits & 0xffffffffULL) * n) >> 32);
+    }
+
+    // ------------------------------------------------------------------
+    // Parsing
+    // ------------------------------------------------------------------
+    struct Parsed {
+        std::string_view section, key, value;
+    };
+
+    static bool blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    static std::string_view trim(std::string_view s) {
+        while (!s.empty() && blank(s.front())) s.remove_prefix(1);
+        while (!s.empty() && blank(s.back())) s.remove_suffix(1);
+        return s;
+    }
+
+    bool fail(std::size_t line) {
+        error_line_ = line;
+        errno = EINVAL;
+        return false;
+    }
+
+    bool parse_lines(std::string_view text, std::vector<Parsed>& out) {
+        std::string_view section;
+        std::size_t line_no = 0;
+        while (!text.empty()) {
+            ++line_no;
+            const std::size_t eol = std::min(text.find('\n'), text.size());
+            std::string_view line = trim(text.substr(0, eol));
+            text.remove_prefix(std::min(eol + 1, text.size()));
+            if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+
+            if (line[0] == '[') {
+                if (line.back() != ']') return fail(line_no);
+                section = trim(line.substr(1, line.size() - 2));
+                continue;
+            }
+            const std::size_t eq = line.find('=');
+            if (eq == std::string_view::npos) return fail(line_no);
+            Parsed p{section, trim(line.substr(0, eq)), trim(line.substr(eq + 1))};
+            if (p.key.empty()) return fail(line_no);
+            std::string_view& v = p.value;
+            if (!v.empty() && v[0] == '"') {
+                const std::size_t close = v.find('"', 1);
+                if (close == std::string_view::npos) return fail(line_no);
+                v = v.substr(1, close - 1);
+            } else {
+                for (std::size_t i = 1; i < v.size(); ++i)
+                    if ((v[i] == '#' || v[i] == ';') && blank(v[i - 1])) {
+                        v = trim(v.substr(0, i));
+                        break;
+                    }
+            }
+            out.push_back(p);
+        }
+        return true;
+    }
+
+    bool parse_and_index(std::string_view text) {
+        std::vector<Parsed> parsed;
+        parsed.reserve(static_cast<std::size_t>(std::count(text.begin(), text.end(), '=')));
+        if (!parse_lines(text, parsed)) return false;
+
+        // Full names for keys inside a section, in one buffer sized up front.
+        std::size_t extra = 0;
+        for (const Parsed& p : parsed)
+            if (!p.section.empty()) extra += p.section.size() + 1 + p.key.size();
+        section_keys_.reserve(extra);
+        std::vector<Entry> entries;
+        entries.reserve(parsed.size());
+        for (const Parsed& p : parsed) {
+            std::string_view key = p.key;
+            if (!p.section.empty()) {
+                const std::size_t at = section_keys_.size();
+                section_keys_.append(p.section).append(1, '.').append(p.key);
+                key = std::string_view(section_keys_.data() + at, section_keys_.size() - at);
+            }
+            entries.push_back({key, p.value});
+        }
+        return build(entries);
+    }
+
+    // ------------------------------------------------------------------
+    // Building the minimal perfect hash
+    // ------------------------------------------------------------------
+    bool build(std::vector<Entry>& entries) {
+        // A few global seeds, in case two keys share all 64 hash bits.
+        for (seed_ = 0; seed_ < 4; ++seed_) {
+            std::vector<std::uint64_t> hashes;
+            if (!unique(entries, hashes)) continue;
+            if (place(entries, hashes)) return true;
+        }
+        errno = EINVAL;
+        return false;
+    }
+
+    // Drops all but the last setting of each key. Fails (for this seed) if
+    // two different keys have the same hash.
+    bool unique(std::vector<Entry>& entries, std::vector<std::uint64_t>& hashes) const {
+        const std::size_t n = entries.size();
+        std::vector<std::pair<std::uint64_t, std::uint32_t>> order(n);  // (hash, line order)
+        for (std::size_t i = 0; i < n; ++i) order[i] = {hash(entries[i].key, seed_), static_cast<std::uint32_t>(i)};
+        std::sort(order.begin(), order.end());
+        std::vector<char> keep(n, 1);
+        for (std::size_t i = 0; i + 1 < n; ++i) {
+            if (order[i].first != order[i + 1].first) continue;
+            if (entries[order[i].second].key != entries[order[i + 1].second].key) return false;
+            keep[order[i].second] = 0;  // the next one is later in the file
+        }
+        std::vector<std::uint64_t> h(n);
+        for (const auto& o : order) h[o.second] = o.first;
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            if (keep[i]) {
+                entries[out] = entries[i];
+                h[out++] = h[i];
+            }
+        entries.resize(out);
+        h.resize(out);
+        hashes = std::move(h);
+        return true;
+    }
+
+    bool place(const std::vector<Entry>& entries, const std::vector<std::uint64_t>& hashes) {
+        const std::size_t n = entries.size();
+        if (n > INT32_MAX) return false;  // slots are stored as int32
+        slots_.assign(n, Entry{});
+        buckets_.assign(n, 0);
+        if (n == 0) return true;
+
+        // Keys per bucket, largest buckets first: they are the hardest to place.
+        std::vector<std::uint32_t> start(n + 1, 0), members(n);
+        for (std::uint64_t h : hashes) ++start[range(h >> 32, n) + 1];
+        for (std::size_t b = 0; b < n; ++b) start[b + 1] += start[b];
+        {
+            std::vector<std::uint32_t> fill(start.begin(), start.end() - 1);
+            for (std::size_t i = 0; i < n; ++i)
+                members[fill[range(hashes[i] >> 32, n)]++] = static_cast<std::uint32_t>(i);
+        }
+        std::size_t largest = 0;
+        for (std::size_t b = 0; b < n; ++b) largest = std::max<std::size_t>(largest, start[b + 1] - start[b]);
+        std::vector<std::uint32_t> by_size;  // counting sort, largest first
+        by_size.reserve(n);
+        for (std::size_t size = largest; size > 0; --size)
+            for (std::size_t b = 0; b < n; ++b)
+                if (start[b + 1] - start[b] == size) by_size.push_back(static_cast<std::uint32_t>(b));
+
+        std::vector<char> taken(n, 0);
+        std::vector<std::size_t> trial;
+        std::size_t free_slot = 0;
+        for (std::uint32_t b : by_size) {
+            const std::uint32_t size = start[b + 1] - start[b];
+            if (size == 1) {  // any free slot will do
+                while (taken[free_slot]) ++free_slot;
+                taken[free_slot] = 1;
+                slots_[free_slot] = entries[members[start[b]]];
+                buckets_[b] = -static_cast<std::int32_t>(free_slot) - 1;
+                continue;
+            }
+            std::int32_t seed = 0;
+            for (;; ++seed) {
+                if (seed == (1 << 24)) return false;
+                trial.clear();
+                bool ok = true;
+                for (std::uint32_t m = start[b]; ok && m < start[b + 1]; ++m) {
+                    const std::size_t s = range(displace(hashes[members[m]], seed), n);
+                    ok = !taken[s] && std::find(trial.begin(), trial.end(), s) == trial.end();
+                    trial.push_back(s);
+                }
+                if (ok) break;
+            }
+            for (std::uint32_t m = start[b]; m < start[b + 1]; ++m) {
+                const std::size_t s = trial[m - start[b]];
+                taken[s] = 1;
+                slots_[s] = entries[members[m]];
+            }
+            buckets_[b] = seed;
+        }
+        return true;
+    }
+};
+
+#endif // CONFIG_FILE_HPP
@@ -0,0 +1,562 @@
+// external_sort.cpp
+// A complete C++17 tool and tutorial: sorting Record files larger than RAM.
+// Compile: g++ -std=c++17 -Wall -Wextra -O2 -pthread external_sort.cpp -o external_sort
+// Run:     ./external_sort input.bin output.bin [--key id|score] [--memory MiB] [--tmp dir]
+//          ./external_sort --generate records.bin N      (random test file)
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "record.hpp"
+#include "../multithreading/work_stealing_pool.hpp"
+
+/*
+External merge sort in two phases:
+
+1. Run generation
+   Read as many records as half the memory budget allows, sort them in memory
+   (one slice per pool worker with std::stable_sort, then pairwise
+   std::inplace_merge rounds, also in parallel), and write the sorted run to
+   the temp directory.
+   The other half of the budget is scratch space for the merges.
+
+2. K-way merge
+   Every run gets a read buffer of budget / (2 * (k + 1)) bytes, split in two
+   halves: while the merge consumes one half, the I/O thread fills the other
+   with pread(). The output uses the same double buffering with write(). The next
+   smallest record among k runs comes from a loser tree: after popping the
+   winner, only the path from its leaf to the root is replayed, that is
+   log2(k) comparisons per record instead of k.
+   If there are too many runs for buffers of MinBufferBytes, several merge
+   passes are done, each merging up to MaxFanIn runs into a bigger one.
+
+Interesting facts & pitfalls:
+- Records with equal keys keep their input order: each run is sorted stably
+  and the loser tree breaks ties by run number.
+- Temp runs need as much disk space as the input. They are removed on
+  every exit path, errors included.
+- A read error is an error, not an early end of file: the output must hold
+  as many records as the input, and the tool checks that it does.
+- A trailing partial record (file size not a multiple of sizeof(Record))
+  is reported and left out.
+- pread() is safe to call from the prefetch task because it does not move
+  the file offset.
+- Sorting runs on WorkStealingPool::shared(); the blocking pread()/write()
+  calls go to one dedicated IoThread instead. On the pool they would block
+  workers, and a merge started from a pool task would wait with
+  future::get() for I/O queued behind it on the same busy workers.
+  std::async(launch::async) would start a new thread per buffer.
+*/
+
+namespace fs = std::filesystem;
+
+enum class SortKey { Id, Score };
+
+struct Options {
+    std::string input, output;
+    fs::path tmp_dir = fs::temp_directory_path();
+    std::size_t memory_bytes = std::size_t(256) << 20;
+    SortKey key = SortKey::Id;
+};
+
+struct KeyLess {
+    SortKey key;
+    bool operator()(const Record& a, const Record& b) const {
+        return key == SortKey::Id ? a.id < b.id : a.score < b.score;
+    }
+};
+
+const std::size_t MinBufferBytes = std::size_t(1) << 20;
+
+// --------------------------------------------------------------------
+// Phase 1 helpers
+// --------------------------------------------------------------------
+
+// Stable sort of recs on the pool: sort slices, then merge neighbours.
+void parallel_sort(std::vector<Record>& recs, KeyLess less) {
+    WorkStealingPool& pool = WorkStealingPool::shared();
+    const std::size_t n = recs.size();
+    std::size_t slices = pool.size();
+    if (n < (std::size_t(1) << 16)) slices = 1;
+
+    std::vector<std::size_t> cut(slices + 1);
+    for (std::size_t t = 0; t <= slices; ++t) cut[t] = n * t / slices;
+
+    pool.parallel_for(0, slices, [&](std::size_t t) {
+        std::stable_sort(recs.begin() + cut[t], recs.begin() + cut[t + 1], less);
+    }, 1);
+
+    for (std::size_t width = 1; width < slices; width *= 2) {
+        const std::size_t pairs = (slices - width + 2 * width - 1) / (2 * width);
+        pool.parallel_for(0, pairs, [&](std::size_t p) {
+            const std::size_t t = p * 2 * width;
+            std::size_t lo = cut[t], mid = cut[t + width];
+            std::size_t hi = cut[std::min(t + 2 * width, slices)];
+            std::inplace_merge(recs.begin() + lo, recs.begin() + mid, recs.begin() + hi, less);
+        }, 1);
+    }
+}
+
+bool write_all(int fd, const void* data, std::size_t bytes) {
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t w = ::write(fd, p, bytes);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        p += w;
+        bytes -= static_cast<std::size_t>(w);
+    }
+    return true;
+}
+
+// Reads up to bytes at offset; returns the byte count (short only at end of
+// file) or -1 with errno set on a read error.
+ssize_t pread_all(int fd, void* data, std::size_t bytes, off_t offset) {
+    char* p = static_cast<char*>(data);
+    std::size_t done = 0;
+    while (done < bytes) {
+        ssize_t r = ::pread(fd, p + done, bytes - done, offset + static_cast<off_t>(done));
+        if (r < 0 && errno == EINTR) continue;
+        if (r < 0) return -1;
+        if (r == 0) break;
+        done += static_cast<std::size_t>(r);
+    }
+    return static_cast<ssize_t>(done);
+}
+
+// One thread that runs blocking I/O jobs in order. It never waits for
+// anything but the disk, so waiting for its futures with get() is safe
+// from any thread, pool workers included.
+class IoThread {
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> jobs_;
+    bool stop_ = false;
+    std::thread thread_;
+
+    void run() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_);
+                cv_.wait(lock, [&] { return stop_ || !jobs_.empty(); });
+                if (jobs_.empty()) return;
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            job();
+        }
+    }
+
+public:
+    IoThread() : thread_([this] { run(); }) {}
+    ~IoThread() {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+    template <class F>
+    auto submit(F f) -> std::future<decltype(f())> {
+        auto task = std::make_shared<std::packaged_task<decltype(f())()>>(std::move(f));
+        auto result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            jobs_.emplace_back([task] { (*task)(); });
+        }
+        cv_.notify_one();
+        return result;
+    }
+
+    static IoThread& shared() {
+        static IoThread io;
+        return io;
+    }
+};
+
+// Removes temp runs; errors are ignored, this is cleanup.
+void remove_runs(const std::vector<std::string>& runs) {
+    std::error_code ec;
+    for (const auto& r : runs) fs::remove(r, ec);
+}
+
+// --------------------------------------------------------------------
+// Phase 2 helpers: double-buffered reader and writer
+// --------------------------------------------------------------------
+
+class RunReader {
+    int fd_ = -1;
+    off_t offset_ = 0;
+    std::vector<Record> buf_[2];
+    std::size_t count_ = 0, pos_ = 0;   // records in the current half
+    int cur_ = 0;
+    int error_ = 0;                     // errno of the first failed read
+    std::future<ssize_t> next_;         // filling buf_[1 - cur_], bytes or -errno
+
+    void prefetch() {
+        int half = 1 - cur_;
+        off_t at = offset_;
+        offset_ += static_cast<off_t>(buf_[half].size() * sizeof(Record));
+        next_ = IoThread::shared().submit([this, half, at] {
+            ssize_t got = pread_all(fd_, buf_[half].data(), buf_[half].size() * sizeof(Record), at);
+            return got < 0 ? -static_cast<ssize_t>(errno) : got;
+        });
+    }
+
+public:
+    RunReader(const std::string& path, std::size_t buffer_bytes) {
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        std::size_t recs = std::max<std::size_t>(1, buffer_bytes / 2 / sizeof(Record));
+        buf_[0].resize(recs);
+        buf_[1].resize(recs);
+        if (fd_ < 0) return;
+        cur_ = 1;          // so that the first prefetch fills buf_[0]
+        prefetch();
+        advance_half();
+    }
+    ~RunReader() {
+        if (next_.valid()) next_.wait();
+        if (fd_ >= 0) ::close(fd_);
+    }
+    RunReader(const RunReader&) = delete;
+    RunReader& operator=(const RunReader&) = delete;
+
+    bool ok() const { return fd_ >= 0; }
+    // After a failed read the run looks empty; check error() at the end.
+    int error() const { return error_; }
+    bool empty() const { return pos_ >= count_; }
+    const Record& front() const { return buf_[cur_][pos_]; }
+
+    // Swaps to the prefetched half and starts reading the next one.
+    void advance_half() {
+        const ssize_t got = next_.get();
+        if (got < 0 && error_ == 0) error_ = static_cast<int>(-got);
+        count_ = got < 0 ? 0 : static_cast<std::size_t>(got) / sizeof(Record);
+        cur_ = 1 - cur_;
+        pos_ = 0;
+        if (count_ == buf_[cur_].size()) prefetch();
+    }
+    void pop() {
+        if (++pos_ == count_ && count_ == buf_[cur_].size()) advance_half();
+    }
+};
+
+class RunWriter {
+    int fd_ = -1;
+    std::vector<Record> buf_[2];
+    std::size_t count_ = 0;
+    int cur_ = 0;
+    std::future<bool> pending_;
+    bool ok_ = true;
+
+    void flush_async() {
+        if (pending_.valid()) ok_ = pending_.get() && ok_;
+        const Record* data = buf_[cur_].data();
+        std::size_t bytes = count_ * sizeof(Record);
+        pending_ = IoThread::shared().submit([this, data, bytes] {
+            return write_all(fd_, data, bytes);
+        });
+        cur_ = 1 - cur_;
+        count_ = 0;
+    }
+
+public:
+    RunWriter(const std::string& path, std::size_t buffer_bytes) {
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        std::size_t recs = std::max<std::size_t>(1, buffer_bytes / 2 / sizeof(Record));
+        buf_[0].resize(recs);
+        buf_[1].resize(recs);
+        ok_ = fd_ >= 0;
+    }
+    ~RunWriter() { close(); }
+    RunWriter(const RunWriter&) = delete;
+    RunWriter& operator=(const RunWriter&) = delete;
+
+    void push(const Record& r) {
+        buf_[cur_][count_++] = r;
+        if (count_ == buf_[cur_].size()) flush_async();
+    }
+    // Flushes everything; returns false if any write failed.
+    bool close() {
+        if (fd_ < 0) return ok_;
+        if (count_ > 0) flush_async();
+        if (pending_.valid()) ok_ = pending_.get() && ok_;
+        ::close(fd_);
+        fd_ = -1;
+        return ok_;
+    }
+};
+
+// --------------------------------------------------------------------
+// Loser tree
+// --------------------------------------------------------------------
+
+class LoserTree {
+    std::vector<RunReader*> runs_;
+    std::vector<int> tree_;  // tree_[0] = winner, tree_[1..k) = losers
+    KeyLess less_;
+
+    // Exhausted runs lose against everything; ties go to the lower run.
+    bool beats(int a, int b) const {
+        if (runs_[a]->empty()) return false;
+        if (runs_[b]->empty()) return true;
+        if (less_(runs_[a]->front(), runs_[b]->front())) return true;
+        if (less_(runs_[b]->front(), runs_[a]->front())) return false;
+        return a < b;
+    }
+
+public:
+    LoserTree(std::vector<RunReader*> runs, KeyLess less)
+        : runs_(std::move(runs)), tree_(runs_.size(), 0), less_(less) {
+        const int k = static_cast<int>(runs_.size());
+        std::vector<int> winner(2 * k);
+        for (int i = 0; i < k; ++i) winner[k + i] = i;
+        for (int node = k - 1; node >= 1; --node) {
+            int a = winner[2 * node], b = winner[2 * node + 1];
+            bool a_wins = beats(a, b);
+            winner[node] = a_wins ? a : b;
+            tree_[node] = a_wins ? b : a;
+        }
+        tree_[0] = (k == 1) ? 0 : winner[1];
+    }
+
+    bool empty() const { return runs_[tree_[0]]->empty(); }
+    const Record& top() const { return runs_[tree_[0]]->front(); }
+
+    void pop() {
+        const int k = static_cast<int>(runs_.size());
+        int s = tree_[0];
+        runs_[s]->pop();
+        for (int node = (s + k) / 2; node > 0; node /= 2)
+            if (beats(tree_[node], s)) std::swap(tree_[node], s);
+        tree_[0] = s;
+    }
+};
+
+// Merges runs into output; every run gets the same share of the budget.
+bool merge_runs(const std::vector<std::string>& runs, const std::string& output,
+                const Options& opt) {
+    const std::size_t buffer = opt.memory_bytes / (runs.size() + 1);
+    std::vector<std::unique_ptr<RunReader>> readers;
+    std::vector<RunReader*> raw;
+    for (const auto& path : runs) {
+        readers.push_back(std::make_unique<RunReader>(path, buffer));
+        if (!readers.back()->ok()) {
+            std::cerr << "Error: Cannot open run " << path << "\n";
+            return false;
+        }
+        raw.push_back(readers.back().get());
+    }
+    RunWriter out(output, buffer);
+    LoserTree tree(raw, KeyLess{opt.key});
+    while (!tree.empty()) {
+        out.push(tree.top());
+        tree.pop();
+    }
+    bool ok = out.close();
+    if (!ok) std::cerr << "Error: Cannot write " << output << "\n";
+    for (std::size_t i = 0; i < runs.size(); ++i)
+        if (readers[i]->error() != 0) {
+            std::cerr << "Error: Cannot read run " << runs[i] << ": " << std::strerror(readers[i]->error()) << "\n";
+            ok = false;
+        }
+    return ok;
+}
+
+// --------------------------------------------------------------------
+// Driver
+// --------------------------------------------------------------------
+
+bool external_sort(const Options& opt) {
+    int in = ::open(opt.input.c_str(), O_RDONLY);
+    if (in < 0) {
+        std::cerr << "Error: Cannot open " << opt.input << "\n";
+        return false;
+    }
+
+    // Phase 1: sorted runs of half the budget each.
+    const std::size_t run_records = std::max<std::size_t>(1, opt.memory_bytes / 2 / sizeof(Record));
+    std::vector<std::string> runs;
+    std::vector<Record> recs(run_records);
+    const std::string stem = "extsort_" + std::to_string(::getpid()) + "_";
+    off_t offset = 0;
+    std::size_t total = 0;
+    for (;;) {
+        ssize_t bytes = pread_all(in, recs.data(), run_records * sizeof(Record), offset);
+        if (bytes < 0) {
+            std::cerr << "Error: Cannot read " << opt.input << ": " << std::strerror(errno) << "\n";
+            remove_runs(runs);
+            ::close(in);
+            return false;
+        }
+        std::size_t got = static_cast<std::size_t>(bytes) / sizeof(Record);
+        if (got == 0) {
+            if (bytes > 0)
+                std::cerr << "Warning: " << bytes << " trailing byte(s) of " << opt.input
+                          << " are not a whole record and are left out.\n";
+            break;
+        }
+        offset += static_cast<off_t>(got * sizeof(Record));
+        total += got;
+        recs.resize(got);
+        parallel_sort(recs, KeyLess{opt.key});
+        std::string path = (opt.tmp_dir / (stem + std::to_string(runs.size()) + ".run")).string();
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        bool ok = fd >= 0 && write_all(fd, recs.data(), got * sizeof(Record));
+        if (fd >= 0) ::close(fd);
+        runs.push_back(path);
+        if (!ok) {
+            std::cerr << "Error: Cannot write run " << path << "\n";
+            remove_runs(runs);
+            ::close(in);
+            return false;
+        }
+        recs.resize(run_records);
+    }
+    ::close(in);
+    std::vector<Record>().swap(recs);
+    std::cout << "Phase 1: " << runs.size() << " sorted run(s) of up to "
+              << run_records << " records.\n";
+
+    if (runs.empty()) {  // empty input -> empty output
+        RunWriter out(opt.output, sizeof(Record) * 2);
+        return out.close();
+    }
+
+    // Phase 2: merge passes until one run is left.
+    const std::size_t max_fan_in = std::max<std::size_t>(2, opt.memory_bytes / MinBufferBytes - 1);
+    std::size_t pass = 0;
+    bool ok = true;
+    while (ok && runs.size() > 1) {
+        std::vector<std::string> next;
+        const bool last = runs.size() <= max_fan_in;
+        for (std::size_t i = 0; i < runs.size(); i += max_fan_in) {
+            std::vector<std::string> group(runs.begin() + i,
+                                           runs.begin() + std::min(runs.size(), i + max_fan_in));
+            std::string dst = last ? opt.output
+                : (opt.tmp_dir / (stem + "p" + std::to_string(pass) + "_" + std::to_string(next.size()) + ".run")).string();
+            next.push_back(dst);
+            if (!merge_runs(group, dst, opt)) {
+                // Inputs are only removed after a merge succeeded; now that
+                // the sort is abandoned, every temp run goes, partial dst too.
+                remove_runs(next);
+                remove_runs(std::vector<std::string>(runs.begin() + i, runs.end()));
+                return false;
+            }
+            remove_runs(group);
+        }
+        std::cout << "Phase 2: pass " << pass++ << " merged into " << next.size() << " run(s).\n";
+        runs = next;
+    }
+    if (ok && runs.size() == 1 && runs[0] != opt.output) {
+        // A single run is already the sorted output.
+        std::error_code ec;
+        fs::rename(runs[0], opt.output, ec);
+        if (ec) {
+            fs::copy_file(runs[0], opt.output, fs::copy_options::overwrite_existing, ec);
+            remove_runs(runs);
+        }
+        ok = !ec;
+    }
+    if (!ok) return false;
+
+    // Every record read must be in the output.
+    std::error_code ec;
+    const std::uintmax_t bytes = fs::file_size(opt.output, ec);
+    if (ec || bytes != total * sizeof(Record)) {
+        std::cerr << "Error: " << opt.output << " has " << (ec ? 0 : bytes / sizeof(Record))
+                  << " records, the input has " << total << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool generate(const std::string& path, std::size_t n) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<float> score(0.0f, 100.0f);
+    RunWriter out(path, std::size_t(8) << 20);
+    for (std::size_t i = 0; i < n; ++i) {
+        Record r{};
+        std::snprintf(r.name, sizeof(r.name), "user%u", static_cast<unsigned>(i));
+        r.id = static_cast<std::uint32_t>(gen());
+        r.score = score(gen);
+        r.age = static_cast<std::uint16_t>(18 + gen() % 60);
+        out.push(r);
+    }
+    return out.close();
+}
+
+bool is_sorted_file(const std::string& path, KeyLess less) {
+    RunReader in(path, std::size_t(8) << 20);
+    if (!in.ok()) return false;
+    Record prev{};
+    bool first = true;
+    while (!in.empty()) {
+        if (!first && less(in.front(), prev)) return false;
+        prev = in.front();
+        first = false;
+        in.pop();
+    }
+    return in.error() == 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 4 && std::string(argv[1]) == "--generate") {
+        if (!generate(argv[2], std::stoul(argv[3]))) {
+            std::cerr << "Error: Cannot write " << argv[2] << "\n";
+            return 1;
+        }
+        std::cout << "Wrote " << argv[3] << " random records to " << argv[2] << "\n";
+        return 0;
+    }
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0]
+                  << " input.bin output.bin [--key id|score] [--memory MiB] [--tmp dir]\n"
+                  << "       " << argv[0] << " --generate file.bin N\n";
+        return 1;
+    }
+
+    Options opt;
+    opt.input = argv[1];
+    opt.output = argv[2];
+    for (int i = 3; i + 1 < argc; i += 2) {
+        std::string flag = argv[i], value = argv[i + 1];
+        if (flag == "--key" && (value == "id" || value == "score")) {
+            opt.key = (value == "id") ? SortKey::Id : SortKey::Score;
+        } else if (flag == "--memory") {
+            opt.memory_bytes = std::max<std::size_t>(std::stoul(value), 1) << 20;
+        } else if (flag == "--tmp") {
+            opt.tmp_dir = value;
+        } else {
+            std::cerr << "Error: Unknown option " << flag << " " << value << "\n";
+            return 1;
+        }
+    }
+
+    if (!external_sort(opt)) return 1;
+    const bool sorted = is_sorted_file(opt.output, KeyLess{opt.key});
+    std::cout << "Sorted " << fs::file_size(opt.output) / sizeof(Record) << " records into "
+              << opt.output << (sorted ? " (verified)" : " (NOT sorted or unreadable!)") << "\n";
+    return sorted ? 0 : 1;
+}
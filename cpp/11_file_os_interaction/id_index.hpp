@@ -0,0 +1,518 @@
+// id_index.hpp
+// IdIndex: an on-disk B+tree mapping Record::id to record positions.
+//
+//   IdIndex idx;
+//   idx.create("records.idx");
+//   idx.bulk_load([&](std::uint32_t& id, std::uint64_t& pos) { ... });  // sorted
+//   idx.insert(id, pos);                                                // later
+//   idx.scan(100, 200, [](std::uint32_t id, std::uint64_t pos) { ...; return true; });
+//
+// The index file is an array of 4 KiB pages:
+//   page 0        meta (root page, height, counts)
+//   inner pages   up to 254 separator keys and 255 child page numbers
+//   leaf pages    up to 340 (id, position) entries, linked left to right
+//
+// Ids may repeat, so entries are ordered by (id, position) and every key in
+// the tree is that pair: duplicates then behave like distinct keys.
+//
+// Pages go through a small cache. Inner pages, about 1/250 of the index,
+// stay resident once read, so a lookup costs one leaf read after warm-up.
+// Leaves live in an LRU list of leaf_cache_pages frames, written back when
+// evicted or at flush(). Pages use the host byte order: the index is
+// derived data, rebuild it rather than copying it between machines.
+//
+// Errors are reported by returning false with errno set (EINVAL for a file
+// that is not an index or is truncated). A leaf that cannot be written back
+// stays cached and dirty, and the call that needed its frame fails.
+
+#ifndef ID_INDEX_HPP
+#define ID_INDEX_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+class IdIndex {
+public:
+    static constexpr std::size_t page_size = 4096;
+    static constexpr std::size_t leaf_capacity = 340;
+    static constexpr std::size_t inner_capacity = 254;  // keys; children = keys + 1
+
+    struct Stats {
+        std::uint64_t page_reads = 0;
+        std::uint64_t page_writes = 0;
+        std::uint64_t cache_hits = 0;
+    };
+
+    explicit IdIndex(std::size_t leaf_cache_pages = 1024)
+        : leaf_cache_pages_(std::max<std::size_t>(leaf_cache_pages, 4)) {}
+    ~IdIndex() { close(); }
+    IdIndex(const IdIndex&) = delete;
+    IdIndex& operator=(const IdIndex&) = delete;
+
+    // Creates an empty index (one empty leaf), replacing any existing file.
+    bool create(const std::string& path) {
+        close();
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) return false;
+        meta_ = Meta{};
+        meta_.page_count = 1;
+        Node* root = allocate(Leaf);
+        if (root == nullptr) {
+            int err = errno;
+            ::close(fd_);
+            fd_ = -1;
+            errno = err;
+            return false;
+        }
+        meta_.root = root->page_no;
+        meta_.height = 1;
+        return flush();
+    }
+
+    bool open(const std::string& path) {
+        close();
+        fd_ = ::open(path.c_str(), O_RDWR);
+        if (fd_ < 0) return false;
+        Meta m;
+        if (::pread(fd_, &m, sizeof(m), 0) != static_cast<ssize_t>(sizeof(m)) ||
+            std::memcmp(m.magic, meta_magic, sizeof(m.magic)) != 0 ||
+            m.page_size != page_size || m.version != 1) {
+            ::close(fd_);
+            fd_ = -1;
+            errno = EINVAL;
+            return false;
+        }
+        meta_ = m;
+        return true;
+    }
+
+    // Writes back every dirty page, then the meta page, then fdatasync.
+    bool flush() {
+        if (fd_ < 0) return true;
+        bool ok = true;
+        for (auto& kv : inner_)
+            ok = write_back(*kv.second) && ok;
+        for (auto& node : lru_)
+            ok = write_back(*node) && ok;
+        Meta m = meta_;
+        ok = ::pwrite(fd_, &m, sizeof(m), 0) == static_cast<ssize_t>(sizeof(m)) && ok;
+        return ::fdatasync(fd_) == 0 && ok;
+    }
+
+    bool close() {
+        if (fd_ < 0) return true;
+        bool ok = flush();
+        ok = (::close(fd_) == 0) && ok;
+        fd_ = -1;
+        inner_.clear();
+        lru_.clear();
+        leaf_pos_.clear();
+        return ok;
+    }
+
+    std::uint64_t size() const { return meta_.entry_count; }
+    std::uint32_t height() const { return meta_.height; }
+    std::uint32_t page_count() const { return meta_.page_count; }
+    const Stats& stats() const { return stats_; }
+
+    // Number of data file records covered by the index; the caller keeps it
+    // up to date so that appended records can be indexed incrementally.
+    std::uint64_t indexed_records() const { return meta_.indexed_records; }
+    void set_indexed_records(std::uint64_t n) { meta_.indexed_records = n; }
+
+    // Builds the tree bottom-up from entries in (id, position) order, with
+    // full leaves. next(id, pos) fills the next entry and returns false at
+    // the end. The index must be empty.
+    template <class Next>
+    bool bulk_load(Next next) {
+        if (fd_ < 0 || meta_.entry_count != 0) {
+            errno = EINVAL;
+            return false;
+        }
+        std::vector<Child> level;  // first key and page of every node built
+        Node* leaf = get(meta_.root);
+        if (leaf == nullptr) return false;
+        std::uint32_t id;
+        std::uint64_t pos;
+        while (next(id, pos)) {
+            if (leaf->leaf.count == leaf_capacity) {
+                Node* fresh = allocate(Leaf);
+                if (fresh == nullptr) return false;
+                leaf = get(level.back().page);  // allocate may have evicted it
+                if (leaf == nullptr) return false;
+                leaf->leaf.next = fresh->page_no;
+                leaf->dirty = true;
+                leaf = fresh;
+            }
+            if (leaf->leaf.count == 0) level.push_back({id, pos, leaf->page_no});
+            leaf->leaf.ids[leaf->leaf.count] = id;
+            leaf->leaf.pos[leaf->leaf.count] = pos;
+            ++leaf->leaf.count;
+            leaf->dirty = true;
+            ++meta_.entry_count;
+        }
+        while (level.size() > 1) {
+            // Children spread evenly, so no inner node is left with one child.
+            const std::size_t nodes = (level.size() + inner_capacity) / (inner_capacity + 1);
+            std::vector<Child> up;
+            std::size_t from = 0;
+            for (std::size_t k = 0; k < nodes; ++k) {
+                std::size_t to = level.size() * (k + 1) / nodes;
+                Node* in = allocate(Inner);
+                up.push_back({level[from].id, level[from].pos, in->page_no});
+                in->inner.child[0] = level[from].page;
+                for (std::size_t c = from + 1; c < to; ++c) {
+                    std::size_t i = c - from - 1;
+                    in->inner.ids[i] = level[c].id;
+                    in->inner.pos[i] = level[c].pos;
+                    in->inner.child[i + 1] = level[c].page;
+                }
+                in->inner.count = static_cast<std::uint16_t>(to - from - 1);
+                from = to;
+            }
+            level.swap(up);
+            ++meta_.height;
+        }
+        if (!level.empty()) meta_.root = level[0].page;
+        return flush();
+    }
+
+    // Adds (id, pos); a pair already present is not added twice.
+    bool insert(std::uint32_t id, std::uint64_t pos) {
+        if (fd_ < 0) {
+            errno = EBADF;
+            return false;
+        }
+        // Descend, remembering the inner nodes and the child taken in each.
+        std::vector<std::pair<Node*, std::size_t>> path;
+        Node* n = get(meta_.root);
+        if (n == nullptr) return false;
+        for (std::uint32_t level = 1; level < meta_.height; ++level) {
+            std::size_t c = child_index(n->inner, id, pos);
+            path.emplace_back(n, c);
+            n = get(n->inner.child[c]);
+            if (n == nullptr) return false;
+        }
+        LeafNode& leaf = n->leaf;
+        std::size_t at = lower_bound(leaf.ids, leaf.pos, leaf.count, id, pos);
+        if (at < leaf.count && leaf.ids[at] == id && leaf.pos[at] == pos) return true;
+        if (leaf.count < leaf_capacity) {
+            ++meta_.entry_count;
+            n->dirty = true;
+            insert_at(leaf.ids, leaf.count, at, id);
+            insert_at(leaf.pos, leaf.count, at, pos);
+            ++leaf.count;
+            return true;
+        }
+
+        // Split the leaf. Appending past the last leaf (increasing ids) starts
+        // a new leaf instead of leaving two half-empty ones behind.
+        Node* right = allocate(Leaf);
+        if (right == nullptr) return false;  // nothing changed yet
+        ++meta_.entry_count;
+        n->dirty = true;
+        LeafNode& r = right->leaf;
+        std::uint32_t ids[leaf_capacity + 1];
+        std::uint64_t poss[leaf_capacity + 1];
+        std::copy(leaf.ids, leaf.ids + leaf.count, ids);
+        std::copy(leaf.pos, leaf.pos + leaf.count, poss);
+        insert_at(ids, leaf.count, at, id);
+        insert_at(poss, leaf.count, at, pos);
+        const std::size_t total = leaf_capacity + 1;
+        const std::size_t keep = (at == leaf_capacity && leaf.next == 0) ? leaf_capacity : total / 2;
+        std::copy(ids, ids + keep, leaf.ids);
+        std::copy(poss, poss + keep, leaf.pos);
+        std::copy(ids + keep, ids + total, r.ids);
+        std::copy(poss + keep, poss + total, r.pos);
+        leaf.count = static_cast<std::uint16_t>(keep);
+        r.count = static_cast<std::uint16_t>(total - keep);
+        r.next = leaf.next;
+        leaf.next = right->page_no;
+        return insert_separator(path, r.ids[0], r.pos[0], right->page_no);
+    }
+
+    // Calls f(id, pos) for every entry with lo <= id <= hi, in (id, pos)
+    // order, until f returns false. Returns false if a page cannot be read.
+    template <class F>
+    bool scan(std::uint32_t lo, std::uint32_t hi, F f) {
+        if (fd_ < 0) {
+            errno = EBADF;
+            return false;
+        }
+        if (lo > hi) return true;
+        Node* n = get(meta_.root);
+        for (std::uint32_t level = 1; n != nullptr && level < meta_.height; ++level)
+            n = get(n->inner.child[child_index(n->inner, lo, 0)]);
+        if (n == nullptr) return false;
+        std::size_t i = lower_bound(n->leaf.ids, n->leaf.pos, n->leaf.count, lo, 0);
+        for (;;) {
+            for (; i < n->leaf.count; ++i) {
+                if (n->leaf.ids[i] > hi) return true;
+                if (!f(n->leaf.ids[i], n->leaf.pos[i])) return true;
+            }
+            if (n->leaf.next == 0) return true;
+            n = get(n->leaf.next);
+            if (n == nullptr) return false;
+            i = 0;
+        }
+    }
+
+    // Positions of all records with this id, in file order.
+    bool find(std::uint32_t id, std::vector<std::uint64_t>& out) {
+        out.clear();
+        return scan(id, id, [&](std::uint32_t, std::uint64_t pos) {
+            out.push_back(pos);
+            return true;
+        });
+    }
+
+private:
+    enum PageType : std::uint16_t { Leaf = 1, Inner = 2 };
+
+    static constexpr char meta_magic[8] = {'I', 'D', 'X', 'B', 'T', 'R', 'E', 'E'};
+
+    struct Meta {
+        char magic[8] = {'I', 'D', 'X', 'B', 'T', 'R', 'E', 'E'};
+        std::uint32_t page_size = IdIndex::page_size;
+        std::uint32_t version = 1;
+        std::uint32_t root = 0;
+        std::uint32_t height = 0;       // 1 = the root is a leaf
+        std::uint32_t page_count = 0;
+        std::uint32_t reserved = 0;
+        std::uint64_t entry_count = 0;
+        std::uint64_t indexed_records = 0;
+    };
+
+    // All page layouts start with (type, count) so it can be read from any.
+    struct LeafNode {
+        std::uint16_t type;
+        std::uint16_t count;
+        std::uint32_t next;  // right sibling, 0 = last leaf
+        std::uint8_t pad[8];
+        std::uint32_t ids[leaf_capacity];
+        std::uint64_t pos[leaf_capacity];
+    };
+    // child[i] holds keys < (ids[i], pos[i]); child[count] the rest.
+    struct InnerNode {
+        std::uint16_t type;
+        std::uint16_t count;
+        std::uint8_t pad[12];
+        std::uint32_t ids[inner_capacity];
+        std::uint64_t pos[inner_capacity];
+        std::uint32_t child[inner_capacity + 1];
+        std::uint8_t tail[12];
+    };
+    static_assert(sizeof(LeafNode) == page_size, "leaf must fill one page");
+    static_assert(sizeof(InnerNode) == page_size, "inner node must fill one page");
+
+    struct Node {
+        union {
+            LeafNode leaf;
+            InnerNode inner;
+            unsigned char bytes[page_size];
+        };
+        std::uint32_t page_no = 0;
+        bool dirty = false;
+        Node() { std::memset(bytes, 0, page_size); }
+        std::uint16_t type() const { return leaf.type; }
+    };
+
+    struct Child {
+        std::uint32_t id;
+        std::uint64_t pos;
+        std::uint32_t page;
+    };
+
+    int fd_ = -1;
+    Meta meta_;
+    Stats stats_;
+    std::size_t leaf_cache_pages_;
+    std::unordered_map<std::uint32_t, std::unique_ptr<Node>> inner_;  // never evicted
+    std::list<std::unique_ptr<Node>> lru_;                           // leaves, most recent first
+    std::unordered_map<std::uint32_t, std::list<std::unique_ptr<Node>>::iterator> leaf_pos_;
+
+    static bool key_less(std::uint32_t a_id, std::uint64_t a_pos,
+                         std::uint32_t b_id, std::uint64_t b_pos) {
+        return a_id < b_id || (a_id == b_id && a_pos < b_pos);
+    }
+
+    // First slot whose key is >= (id, pos).
+    static std::size_t lower_bound(const std::uint32_t* ids, const std::uint64_t* pos,
+                                   std::size_t count, std::uint32_t id, std::uint64_t p) {
+        std::size_t lo = 0, hi = count;
+        while (lo < hi) {
+            std::size_t mid = (lo + hi) / 2;
+            if (key_less(ids[mid], pos[mid], id, p)) lo = mid + 1;
+            else hi = mid;
+        }
+        return lo;
+    }
+
+    // Child that may hold (id, pos): the number of separators <= the key.
+    static std::size_t child_index(const InnerNode& in, std::uint32_t id, std::uint64_t pos) {
+        std::size_t lo = 0, hi = in.count;
+        while (lo < hi) {
+            std::size_t mid = (lo + hi) / 2;
+            if (key_less(id, pos, in.ids[mid], in.pos[mid])) hi = mid;
+            else lo = mid + 1;
+        }
+        return lo;
+    }
+
+    template <class T>
+    static void insert_at(T* a, std::size_t count, std::size_t at, T v) {
+        std::copy_backward(a + at, a + count, a + count + 1);
+        a[at] = v;
+    }
+
+    // A page that fails to write stays dirty.
+    bool write_back(Node& n) {
+        if (!n.dirty) return true;
+        ssize_t w = ::pwrite(fd_, n.bytes, page_size, static_cast<off_t>(n.page_no) * page_size);
+        ++stats_.page_writes;
+        if (w != static_cast<ssize_t>(page_size)) {
+            if (w >= 0) errno = EIO;
+            return false;
+        }
+        n.dirty = false;
+        return true;
+    }
+
+    // Caches a node: inner nodes forever, leaves at the front of the LRU.
+    // Null if the leaf to evict cannot be written back; it stays cached.
+    Node* adopt(std::unique_ptr<Node> node) {
+        Node* raw = node.get();
+        if (raw->type() == Inner) {
+            inner_.emplace(raw->page_no, std::move(node));
+            return raw;
+        }
+        if (lru_.size() >= leaf_cache_pages_) {
+            Node& victim = *lru_.back();
+            if (!write_back(victim)) return nullptr;
+            leaf_pos_.erase(victim.page_no);
+            lru_.pop_back();
+        }
+        lru_.push_front(std::move(node));
+        leaf_pos_[raw->page_no] = lru_.begin();
+        return raw;
+    }
+
+    // The returned pointer stays valid for inner nodes; a leaf may be evicted
+    // by later get()/allocate() calls once leaf_cache_pages_ others are used.
+    // Null with errno set if the page cannot be read or cached.
+    Node* get(std::uint32_t page_no) {
+        auto in = inner_.find(page_no);
+        if (in != inner_.end()) {
+            ++stats_.cache_hits;
+            return in->second.get();
+        }
+        auto lf = leaf_pos_.find(page_no);
+        if (lf != leaf_pos_.end()) {
+            ++stats_.cache_hits;
+            lru_.splice(lru_.begin(), lru_, lf->second);
+            return lru_.front().get();
+        }
+        // Every allocated page is cached until it is written back, so a page
+        // missing from the file means a truncated or corrupt index.
+        if (page_no == 0 || page_no >= meta_.page_count) {
+            errno = EINVAL;
+            return nullptr;
+        }
+        auto node = std::make_unique<Node>();
+        node->page_no = page_no;
+        ++stats_.page_reads;
+        std::size_t done = 0;
+        while (done < page_size) {
+            ssize_t r = ::pread(fd_, node->bytes + done, page_size - done,
+                                static_cast<off_t>(page_no) * page_size + static_cast<off_t>(done));
+            if (r < 0 && errno == EINTR) continue;
+            if (r <= 0) {
+                if (r == 0) errno = EINVAL;
+                return nullptr;
+            }
+            done += static_cast<std::size_t>(r);
+        }
+        if (node->type() != Leaf && node->type() != Inner) {
+            errno = EINVAL;
+            return nullptr;
+        }
+        return adopt(std::move(node));
+    }
+
+    // Only a leaf can fail, when its frame needs a write-back that fails.
+    Node* allocate(PageType type) {
+        auto node = std::make_unique<Node>();
+        node->page_no = meta_.page_count;
+        node->leaf.type = type;
+        node->dirty = true;
+        Node* raw = adopt(std::move(node));
+        if (raw != nullptr) ++meta_.page_count;
+        return raw;
+    }
+
+    // Inserts separator (id, pos) with right child page after the child
+    // taken at the deepest level of path, splitting upwards as needed.
+    bool insert_separator(std::vector<std::pair<Node*, std::size_t>>& path,
+                          std::uint32_t id, std::uint64_t pos, std::uint32_t page) {
+        while (!path.empty()) {
+            Node* n = path.back().first;
+            std::size_t c = path.back().second;
+            path.pop_back();
+            InnerNode& in = n->inner;
+            n->dirty = true;
+            if (in.count < inner_capacity) {
+                insert_at(in.ids, in.count, c, id);
+                insert_at(in.pos, in.count, c, pos);
+                insert_at(in.child, in.count + 1, c + 1, page);
+                ++in.count;
+                return true;
+            }
+            // Split: the middle key moves up, the halves go left and right.
+            std::uint32_t ids[inner_capacity + 1];
+            std::uint64_t poss[inner_capacity + 1];
+            std::uint32_t kids[inner_capacity + 2];
+            std::copy(in.ids, in.ids + in.count, ids);
+            std::copy(in.pos, in.pos + in.count, poss);
+            std::copy(in.child, in.child + in.count + 1, kids);
+            insert_at(ids, in.count, c, id);
+            insert_at(poss, in.count, c, pos);
+            insert_at(kids, in.count + 1, c + 1, page);
+            const std::size_t total = inner_capacity + 1, mid = total / 2;
+            Node* right = allocate(Inner);
+            InnerNode& r = right->inner;
+            std::copy(ids, ids + mid, in.ids);
+            std::copy(poss, poss + mid, in.pos);
+            std::copy(kids, kids + mid + 1, in.child);
+            in.count = static_cast<std::uint16_t>(mid);
+            std::copy(ids + mid + 1, ids + total, r.ids);
+            std::copy(poss + mid + 1, poss + total, r.pos);
+            std::copy(kids + mid + 1, kids + total + 1, r.child);
+            r.count = static_cast<std::uint16_t>(total - mid - 1);
+            id = ids[mid];
+            pos = poss[mid];
+            page = right->page_no;
+        }
+        // The root itself split: grow the tree by one level.
+        Node* root = allocate(Inner);
+        root->inner.count = 1;
+        root->inner.ids[0] = id;
+        root->inner.pos[0] = pos;
+        root->inner.child[0] = meta_.root;
+        root->inner.child[1] = page;
+        meta_.root = root->page_no;
+        ++meta_.height;
+        return true;
+    }
+};
+
+#endif // ID_INDEX_HPP
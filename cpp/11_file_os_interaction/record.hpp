@@ -0,0 +1,34 @@
+// record.hpp
+// The Record struct written by serialization.cpp, shared by the tools that
+// work on those binary files (external_sort.cpp, ...).
+//
+// A Record file is nothing more than sizeof(Record) byte structs written
+// back to back, so the layout below must stay identical to the one in
+// serialization.cpp: 16 + 4 + 4 + 2 bytes of members, padded to 28.
+
+#ifndef RECORD_HPP
+#define RECORD_HPP
+
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+
+struct Record {
+    char     name[16];    // fixed-size, null-terminated if you want
+    std::uint32_t id;
+    float    score;
+    std::uint16_t age;
+};
+
+static_assert(std::is_trivially_copyable<Record>::value,
+              "Record is copied with read()/write()/memcpy");
+static_assert(sizeof(Record) == 28, "Record files assume the 28-byte layout");
+
+inline void print_record(const Record& r, std::size_t index) {
+    std::cout << "  [" << index << "] name: \"" << r.name
+              << "\" id: " << r.id
+              << " score: " << r.score
+              << " age: " << r.age << "\n";
+}
+
+#endif // RECORD_HPP
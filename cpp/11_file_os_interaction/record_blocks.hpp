@@ -0,0 +1,583 @@
+// record_blocks.hpp
+// Compressed Record files: blocks of rows with one light-weight encoding per
+// field, decoded by vectorizable bit-unpacking kernels.
+//
+//   blocks::BlockWriter out;
+//   out.open("records.blk");
+//   out.append(recs.data(), recs.size());
+//   out.close();
+//
+//   blocks::BlockReader in;
+//   in.open("records.blk");
+//   std::vector<std::uint32_t> age(blocks::block_rows);
+//   for (std::size_t b = 0; b < in.blocks(); ++b) {
+//       in.decode_ages(b, age.data());       // in.rows_in(b) values
+//       const float* score = in.scores(b);   // stored raw, used in place
+//   }
+//
+// Encodings, chosen per block of block_rows rows:
+//   id     frame of reference (id - min) or delta (id[i] - id[i-1] - min
+//          delta), whichever needs fewer bits, then bit-packed
+//   age    frame of reference, bit-packed
+//   name   code in a file-wide dictionary, bit-packed; a block falls back to
+//          raw 16-byte names once the dictionary holds max_dictionary names
+//   score  raw IEEE floats: their bits do not shrink under these schemes,
+//          and a raw column can be read in place
+//
+// Bit packing works on packs of 256 values spread over 8 lanes: value i sits
+// in lane i % 8, and lane l's bits run through words l, l + 8, l + 16...
+// Unpacking then does the same shifts and masks on 8 neighbouring words,
+// which the compiler maps onto SSE/AVX registers.
+//
+// File layout: 64-byte FileHeader, the blocks (BlockHeader + sections, each
+// block padded to 8 bytes), then a footer with the offset of every block and the
+// dictionary (16 bytes per name). Host byte order, like record_columns.hpp.
+
+#ifndef RECORD_BLOCKS_HPP
+#define RECORD_BLOCKS_HPP
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "record.hpp"
+
+namespace blocks {
+
+constexpr std::size_t pack_values = 256;
+constexpr std::size_t pack_lanes = 8;
+constexpr std::size_t block_rows = 4096;  // a multiple of pack_values
+constexpr std::size_t max_dictionary = std::size_t(1) << 20;
+
+// ----------------------------------------------------------------------------
+// Bit packing
+// ----------------------------------------------------------------------------
+
+inline unsigned bits_for(std::uint64_t max_value) {
+    unsigned b = 0;
+    while (max_value) {
+        ++b;
+        max_value >>= 1;
+    }
+    return b;
+}
+
+// Words used by one pack of width w.
+constexpr std::size_t pack_words(unsigned w) { return pack_lanes * w; }
+
+// Packs in[0, 256) (each < 2^w) into out[0, pack_words(w)). Width 0 (a
+// constant column) takes no words at all.
+inline void pack256(const std::uint32_t* in, std::uint32_t* out, unsigned w) {
+    if (w == 0) return;
+    std::fill(out, out + pack_words(w), 0u);
+    for (std::size_t i = 0; i < pack_values; ++i) {
+        const std::size_t l = i % pack_lanes, bit = (i / pack_lanes) * w;
+        const std::size_t k = bit / 32, s = bit % 32;
+        out[k * pack_lanes + l] |= in[i] << s;
+        if (s + w > 32) out[(k + 1) * pack_lanes + l] |= in[i] >> (32 - s);
+    }
+}
+
+// Unpacks one pack of width W. The inner loops run over the 8 lanes with the
+// same shift for all of them: one vector shift, or, and and per step. They
+// fill a local array first, since in and out could alias as far as the
+// compiler knows, and it would not vectorize the loop at -O2.
+template <unsigned W>
+void unpack256(const std::uint32_t* in, std::uint32_t* out) {
+    if constexpr (W == 0) {
+        std::fill(out, out + pack_values, 0u);
+    } else {
+        constexpr std::uint32_t mask = (W == 32) ? ~0u : (1u << W) - 1;
+        for (unsigned j = 0; j < pack_values / pack_lanes; ++j) {
+            const unsigned bit = j * W, k = bit / 32, s = bit % 32;
+            const std::uint32_t* lo = in + k * pack_lanes;
+            std::uint32_t v[pack_lanes];
+            if (s + W > 32) {
+                const std::uint32_t* hi = lo + pack_lanes;
+                for (unsigned l = 0; l < pack_lanes; ++l)
+                    v[l] = ((lo[l] >> s) | (hi[l] << (32 - s))) & mask;
+            } else {
+                for (unsigned l = 0; l < pack_lanes; ++l)
+                    v[l] = (lo[l] >> s) & mask;
+            }
+            std::memcpy(out + j * pack_lanes, v, sizeof(v));
+        }
+    }
+}
+
+using UnpackFn = void (*)(const std::uint32_t*, std::uint32_t*);
+
+template <std::size_t... W>
+constexpr std::array<UnpackFn, sizeof...(W)> make_unpackers(std::index_sequence<W...>) {
+    return {{&unpack256<static_cast<unsigned>(W)>...}};
+}
+// unpackers[w] unpacks a pack of width w, for w = 0..32.
+inline constexpr std::array<UnpackFn, 33> unpackers = make_unpackers(std::make_index_sequence<33>());
+
+// Packs n values (n <= block_rows) of width w; returns the words written.
+inline std::size_t pack(const std::uint32_t* in, std::size_t n, unsigned w, std::uint32_t* out) {
+    std::uint32_t tmp[pack_values];
+    std::size_t words = 0;
+    for (std::size_t p = 0; p < n; p += pack_values) {
+        const std::size_t m = std::min(pack_values, n - p);
+        std::copy(in + p, in + p + m, tmp);
+        std::fill(tmp + m, tmp + pack_values, 0u);
+        pack256(tmp, out + words, w);
+        words += pack_words(w);
+    }
+    return words;
+}
+
+// Unpacks whole packs: out must have room for n rounded up to 256 values.
+inline void unpack(const std::uint32_t* in, std::size_t n, unsigned w, std::uint32_t* out) {
+    const UnpackFn f = unpackers[w];
+    for (std::size_t p = 0; p < n; p += pack_values, in += pack_words(w))
+        f(in, out + p);
+}
+
+inline std::size_t packed_words(std::size_t n, unsigned w) {
+    return (n + pack_values - 1) / pack_values * pack_words(w);
+}
+
+// ----------------------------------------------------------------------------
+// File format
+// ----------------------------------------------------------------------------
+
+enum IdEncoding : std::uint8_t { IdFor = 0, IdDelta = 1 };
+enum NameEncoding : std::uint8_t { NameDict = 0, NameRaw = 1 };
+
+struct FileHeader {
+    char magic[8] = {'R', 'E', 'C', 'B', 'L', 'K', 'S', '\n'};
+    std::uint32_t version = 1;
+    std::uint32_t block_rows = blocks::block_rows;
+    std::uint64_t row_count = 0;
+    std::uint64_t block_count = 0;
+    std::uint64_t footer_offset = 0;  // block offsets, then the dictionary
+    std::uint64_t dictionary_size = 0;  // names
+    std::uint8_t reserved[16] = {};
+};
+static_assert(sizeof(FileHeader) == 64, "the file header is 64 bytes");
+
+// Sections follow in this order: ids, ages, names, scores.
+struct BlockHeader {
+    std::uint32_t rows;
+    std::uint8_t id_encoding;
+    std::uint8_t id_width;
+    std::uint8_t age_width;
+    std::uint8_t name_encoding;
+    std::uint8_t name_width;
+    std::uint8_t reserved[3];
+    std::uint32_t id_first;   // IdDelta: the first id
+    std::int64_t id_base;     // IdFor: the smallest id; IdDelta: the smallest delta
+    std::uint32_t age_base;
+    std::uint32_t bytes;      // whole block, header included
+};
+static_assert(sizeof(BlockHeader) == 32, "block headers are 32 bytes");
+
+// ----------------------------------------------------------------------------
+// Writer
+// ----------------------------------------------------------------------------
+
+class BlockWriter {
+public:
+    BlockWriter() = default;
+    ~BlockWriter() { close(); }
+    BlockWriter(const BlockWriter&) = delete;
+    BlockWriter& operator=(const BlockWriter&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) return false;
+        header_ = FileHeader{};
+        offset_ = sizeof(FileHeader);
+        ok_ = true;
+        return true;
+    }
+
+    // Rows are buffered and encoded block_rows at a time.
+    bool append(const Record* recs, std::size_t n) {
+        for (std::size_t i = 0; i < n && ok_; ++i) {
+            rows_.push_back(recs[i]);
+            if (rows_.size() == block_rows) flush_block();
+        }
+        return ok_;
+    }
+
+    // Encodes the last partial block, writes footer and header.
+    bool close() {
+        if (fd_ < 0) return ok_;
+        if (!rows_.empty()) flush_block();
+        header_.footer_offset = offset_;
+        header_.dictionary_size = names_.size() / 16;
+        ok_ = write_at(block_offsets_.data(), block_offsets_.size() * sizeof(std::uint64_t), offset_) && ok_;
+        offset_ += block_offsets_.size() * sizeof(std::uint64_t);
+        ok_ = write_at(names_.data(), names_.size(), offset_) && ok_;
+        ok_ = write_at(&header_, sizeof(header_), 0) && ok_;
+        ok_ = (::close(fd_) == 0) && ok_;
+        fd_ = -1;
+        rows_.clear();
+        block_offsets_.clear();
+        names_.clear();
+        codes_.clear();
+        return ok_;
+    }
+
+    std::uint64_t bytes_written() const { return offset_; }
+
+private:
+    int fd_ = -1;
+    bool ok_ = true;
+    FileHeader header_;
+    std::uint64_t offset_ = 0;
+    std::vector<Record> rows_;
+    std::vector<std::uint64_t> block_offsets_;
+    std::string names_;                                   // dictionary, 16 bytes per name
+    std::unordered_map<std::string, std::uint32_t> codes_;
+    std::vector<std::uint32_t> buf_;                      // encoded block
+
+    bool write_at(const void* data, std::size_t bytes, std::uint64_t at) {
+        const char* p = static_cast<const char*>(data);
+        while (bytes > 0) {
+            ssize_t w = ::pwrite(fd_, p, bytes, static_cast<off_t>(at));
+            if (w < 0 && errno == EINTR) continue;
+            if (w <= 0) return false;
+            p += w;
+            at += static_cast<std::uint64_t>(w);
+            bytes -= static_cast<std::size_t>(w);
+        }
+        return true;
+    }
+
+    void flush_block() {
+        const std::size_t n = rows_.size();
+        BlockHeader h{};
+        h.rows = static_cast<std::uint32_t>(n);
+        std::vector<std::uint32_t> v(n);
+
+        // id: FOR vs delta, keep the narrower.
+        std::uint32_t id_min = rows_[0].id, id_max = rows_[0].id;
+        std::int64_t d_min = 0, d_max = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            id_min = std::min(id_min, rows_[i].id);
+            id_max = std::max(id_max, rows_[i].id);
+            if (i > 0) {
+                std::int64_t d = std::int64_t(rows_[i].id) - std::int64_t(rows_[i - 1].id);
+                d_min = (i == 1) ? d : std::min(d_min, d);
+                d_max = (i == 1) ? d : std::max(d_max, d);
+            }
+        }
+        const unsigned for_width = bits_for(id_max - id_min);
+        const unsigned delta_width = bits_for(static_cast<std::uint64_t>(d_max - d_min));
+        buf_.assign(sizeof(BlockHeader) / 4, 0u);
+        if (n > 1 && delta_width < for_width) {
+            h.id_encoding = IdDelta;
+            h.id_width = static_cast<std::uint8_t>(delta_width);
+            h.id_first = rows_[0].id;
+            h.id_base = d_min;
+            v[0] = 0;
+            for (std::size_t i = 1; i < n; ++i)
+                v[i] = static_cast<std::uint32_t>(std::int64_t(rows_[i].id) - rows_[i - 1].id - d_min);
+        } else {
+            h.id_encoding = IdFor;
+            h.id_width = static_cast<std::uint8_t>(for_width);
+            h.id_base = id_min;
+            for (std::size_t i = 0; i < n; ++i) v[i] = rows_[i].id - id_min;
+        }
+        append_packed(v.data(), n, h.id_width);
+
+        // age: FOR.
+        std::uint16_t age_min = rows_[0].age, age_max = rows_[0].age;
+        for (const Record& r : rows_) {
+            age_min = std::min(age_min, r.age);
+            age_max = std::max(age_max, r.age);
+        }
+        h.age_base = age_min;
+        h.age_width = static_cast<std::uint8_t>(bits_for(age_max - age_min));
+        for (std::size_t i = 0; i < n; ++i) v[i] = rows_[i].age - age_min;
+        append_packed(v.data(), n, h.age_width);
+
+        // name: dictionary codes, unless the dictionary would overflow. The
+        // count of new names is only needed once the dictionary gets close.
+        std::size_t fresh = n;
+        if (codes_.size() + n > max_dictionary) {
+            fresh = 0;
+            for (const Record& r : rows_)
+                fresh += codes_.count(std::string(r.name, 16)) == 0;
+        }
+        if (codes_.size() + fresh <= max_dictionary) {
+            for (std::size_t i = 0; i < n; ++i) {
+                auto ins = codes_.emplace(std::string(rows_[i].name, 16),
+                                          static_cast<std::uint32_t>(codes_.size()));
+                if (ins.second) names_.append(rows_[i].name, 16);
+                v[i] = ins.first->second;
+            }
+            h.name_encoding = NameDict;
+            h.name_width = static_cast<std::uint8_t>(bits_for(codes_.size() - 1));
+            append_packed(v.data(), n, h.name_width);
+        } else {
+            h.name_encoding = NameRaw;
+            std::size_t at = buf_.size();
+            buf_.resize(at + n * 4);  // 16 bytes = 4 words per name
+            for (std::size_t i = 0; i < n; ++i) std::memcpy(&buf_[at + 4 * i], rows_[i].name, 16);
+        }
+
+        // score: raw.
+        std::size_t at = buf_.size();
+        buf_.resize(at + n);
+        for (std::size_t i = 0; i < n; ++i) std::memcpy(&buf_[at + i], &rows_[i].score, 4);
+
+        if (buf_.size() % 2) buf_.push_back(0);  // keeps headers and footer 8-byte aligned
+        h.bytes = static_cast<std::uint32_t>(buf_.size() * 4);
+        std::memcpy(buf_.data(), &h, sizeof(h));
+        block_offsets_.push_back(offset_);
+        ok_ = write_at(buf_.data(), h.bytes, offset_) && ok_;
+        offset_ += h.bytes;
+        header_.row_count += n;
+        ++header_.block_count;
+        rows_.clear();
+    }
+
+    void append_packed(const std::uint32_t* v, std::size_t n, unsigned w) {
+        std::size_t at = buf_.size();
+        buf_.resize(at + packed_words(n, w));
+        pack(v, n, w, buf_.data() + at);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Reader
+// ----------------------------------------------------------------------------
+
+class BlockReader {
+public:
+    BlockReader() = default;
+    ~BlockReader() { close(); }
+    BlockReader(const BlockReader&) = delete;
+    BlockReader& operator=(const BlockReader&) = delete;
+
+    // Maps the file; errno is EINVAL if it is not a valid block file.
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(FileHeader)) {
+            ::close(fd);
+            errno = EINVAL;
+            return false;
+        }
+        bytes_ = static_cast<std::size_t>(st.st_size);
+        void* p = ::mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        base_ = static_cast<const unsigned char*>(p);
+        std::memcpy(&h_, base_, sizeof(h_));
+        const FileHeader expected;
+        if (std::memcmp(h_.magic, expected.magic, sizeof(h_.magic)) != 0 || h_.version != 1 ||
+            h_.block_rows != block_rows || h_.footer_offset % 8 != 0 || h_.footer_offset > bytes_ ||
+            h_.block_count > (bytes_ - h_.footer_offset) / 8 ||
+            h_.dictionary_size > (bytes_ - h_.footer_offset - h_.block_count * 8) / 16) {
+            close();
+            errno = EINVAL;
+            return false;
+        }
+        offsets_ = reinterpret_cast<const std::uint64_t*>(base_ + h_.footer_offset);
+        dictionary_ = reinterpret_cast<const char*>(base_ + h_.footer_offset + h_.block_count * 8);
+        for (std::size_t b = 0; b < h_.block_count; ++b) {
+            if (!valid_block(b)) {
+                close();
+                errno = EINVAL;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void close() {
+        if (base_ != nullptr) ::munmap(const_cast<unsigned char*>(base_), bytes_);
+        base_ = nullptr;
+        bytes_ = 0;
+        h_ = FileHeader{};
+    }
+
+    std::size_t rows() const { return h_.row_count; }
+    std::size_t blocks() const { return h_.block_count; }
+    std::size_t file_bytes() const { return bytes_; }
+    std::size_t rows_in(std::size_t b) const { return header(b).rows; }
+
+    // The decode_* functions write rows_in(b) values, but need room for
+    // block_rows in out (whole packs are unpacked).
+    void decode_ids(std::size_t b, std::uint32_t* out) const {
+        const BlockHeader& h = header(b);
+        unpack(section(b, 0), h.rows, h.id_width, out);
+        if (h.id_encoding == IdFor) {
+            const std::uint32_t base = static_cast<std::uint32_t>(h.id_base);
+            for (std::size_t i = 0; i < h.rows; ++i) out[i] += base;
+        } else {
+            const std::uint32_t base = static_cast<std::uint32_t>(h.id_base);  // wraps like the deltas
+            std::uint32_t id = h.id_first;
+            out[0] = id;
+            for (std::size_t i = 1; i < h.rows; ++i) out[i] = id += out[i] + base;
+        }
+    }
+
+    void decode_ages(std::size_t b, std::uint32_t* out) const {
+        const BlockHeader& h = header(b);
+        unpack(section(b, 1), h.rows, h.age_width, out);
+        for (std::size_t i = 0; i < h.rows; ++i) out[i] += h.age_base;
+    }
+
+    // Dictionary codes of the names; false if the block stores raw names.
+    bool decode_name_codes(std::size_t b, std::uint32_t* out) const {
+        const BlockHeader& h = header(b);
+        if (h.name_encoding != NameDict) return false;
+        unpack(section(b, 2), h.rows, h.name_width, out);
+        return true;
+    }
+
+    // The 16 name bytes of dictionary entry code; code < dictionary_size().
+    // open() bounds the code width by the dictionary, but a corrupt block
+    // can still hold codes up to the next power of two: check them first.
+    std::size_t dictionary_size() const { return h_.dictionary_size; }
+    const char* dictionary_name(std::uint32_t code) const { return dictionary_ + 16 * std::size_t(code); }
+
+    const float* scores(std::size_t b) const {
+        return reinterpret_cast<const float*>(section(b, 3));
+    }
+
+    // Decodes block b back into rows; out needs room for block_rows.
+    // False with EINVAL if a name code is outside the dictionary.
+    bool decode_records(std::size_t b, Record* out) const {
+        const BlockHeader& h = header(b);
+        std::vector<std::uint32_t> v(block_rows);
+        decode_ids(b, v.data());
+        for (std::size_t i = 0; i < h.rows; ++i) {
+            std::memset(&out[i], 0, sizeof(Record));
+            out[i].id = v[i];
+        }
+        decode_ages(b, v.data());
+        for (std::size_t i = 0; i < h.rows; ++i) out[i].age = static_cast<std::uint16_t>(v[i]);
+        if (decode_name_codes(b, v.data())) {
+            for (std::size_t i = 0; i < h.rows; ++i) {
+                if (v[i] >= h_.dictionary_size) {
+                    errno = EINVAL;
+                    return false;
+                }
+                std::memcpy(out[i].name, dictionary_name(v[i]), 16);
+            }
+        } else {
+            const char* raw = reinterpret_cast<const char*>(section(b, 2));
+            for (std::size_t i = 0; i < h.rows; ++i) std::memcpy(out[i].name, raw + 16 * i, 16);
+        }
+        const float* s = scores(b);
+        for (std::size_t i = 0; i < h.rows; ++i) out[i].score = s[i];
+        return true;
+    }
+
+private:
+    const unsigned char* base_ = nullptr;
+    std::size_t bytes_ = 0;
+    FileHeader h_;
+    const std::uint64_t* offsets_ = nullptr;
+    const char* dictionary_ = nullptr;
+
+    const BlockHeader& header(std::size_t b) const {
+        return *reinterpret_cast<const BlockHeader*>(base_ + offsets_[b]);
+    }
+
+    // Block b lies between the file header and the footer, its widths have
+    // an unpacker and its sections fit in its bytes. Differences only, so
+    // corrupt offsets cannot overflow.
+    bool valid_block(std::size_t b) const {
+        const std::uint64_t at = offsets_[b];
+        if (at % 8 != 0 || at < sizeof(FileHeader) || at > h_.footer_offset ||
+            h_.footer_offset - at < sizeof(BlockHeader))
+            return false;
+        const BlockHeader& h = header(b);
+        if (h.bytes > h_.footer_offset - at || h.rows > block_rows || h.id_encoding > IdDelta ||
+            h.name_encoding > NameRaw || h.id_width > 32 || h.age_width > 32 || h.name_width > 32)
+            return false;
+        // Codes of a dictionary block are no wider than the largest code.
+        if (h.name_encoding == NameDict && h.rows > 0 &&
+            (h_.dictionary_size == 0 || h.name_width > bits_for(h_.dictionary_size - 1)))
+            return false;
+        // Bounded by block_rows and 32-bit widths: no overflow here.
+        const std::size_t words = packed_words(h.rows, h.id_width) + packed_words(h.rows, h.age_width) +
+                                  (h.name_encoding == NameDict ? packed_words(h.rows, h.name_width)
+                                                               : 4 * std::size_t(h.rows)) +
+                                  h.rows;
+        return sizeof(BlockHeader) + 4 * words <= h.bytes;
+    }
+
+    // Start of section s (0 ids, 1 ages, 2 names, 3 scores) of block b.
+    const std::uint32_t* section(std::size_t b, int s) const {
+        const BlockHeader& h = header(b);
+        const std::uint32_t* p = reinterpret_cast<const std::uint32_t*>(base_ + offsets_[b] + sizeof(BlockHeader));
+        if (s > 0) p += packed_words(h.rows, h.id_width);
+        if (s > 1) p += packed_words(h.rows, h.age_width);
+        if (s > 2) p += (h.name_encoding == NameDict) ? packed_words(h.rows, h.name_width) : 4 * std::size_t(h.rows);
+        return p;
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Scan kernels over decoded columns
+// ----------------------------------------------------------------------------
+// Same shape as the kernels in record_columns.hpp (8 branch-free lanes, float
+// blocks added into a double), for the 32-bit values the unpackers produce.
+// Scores are raw, so columns::sum() works on scores(b) directly.
+
+constexpr std::size_t kernel_block = 512;
+
+inline std::size_t count_between(const std::uint32_t* v, std::size_t n,
+                                 std::uint32_t lo, std::uint32_t hi) {
+    if (lo > hi) return 0;  // hi - lo would wrap around to a huge width
+    const std::uint32_t width = hi - lo;
+    std::size_t count = 0;
+    std::size_t i = 0;
+    while (i + pack_lanes <= n) {
+        std::uint32_t acc[pack_lanes] = {};
+        const std::size_t end = std::min(n - n % pack_lanes, i + kernel_block);
+        for (; i < end; i += pack_lanes)
+            for (std::size_t l = 0; l < pack_lanes; ++l) acc[l] += (v[i + l] - lo) <= width;
+        for (std::uint32_t a : acc) count += a;
+    }
+    for (; i < n; ++i) count += (v[i] - lo) <= width;
+    return count;
+}
+
+// Scores must be finite: the test is a 0 / 1 factor (inf * 0 is NaN).
+inline double sum_where_between(const float* score, const std::uint32_t* v, std::size_t n,
+                                std::uint32_t lo, std::uint32_t hi) {
+    if (lo > hi) return 0.0;
+    const std::uint32_t width = hi - lo;
+    double total = 0;
+    std::size_t i = 0;
+    while (i + pack_lanes <= n) {
+        float acc[pack_lanes] = {};
+        const std::size_t end = std::min(n - n % pack_lanes, i + kernel_block);
+        for (; i < end; i += pack_lanes)
+            for (std::size_t l = 0; l < pack_lanes; ++l)
+                acc[l] += score[i + l] * static_cast<float>((v[i + l] - lo) <= width);
+        for (float a : acc) total += a;
+    }
+    for (; i < n; ++i)
+        if ((v[i] - lo) <= width) total += score[i];
+    return total;
+}
+
+} // namespace blocks
+
+#endif // RECORD_BLOCKS_HPP
@@ -0,0 +1,155 @@
+// record_columns.cpp
+// Complete C++17 tutorial and demo: row vs columnar layout for Record
+// Compile: g++ -std=c++17 -Wall -Wextra -O2 -march=native record_columns.cpp -o record_columns
+//          (-march=native lets the column kernels use AVX2 where available)
+// Run: ./record_columns [records.bin]     (without a file: 10000000 random rows)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "record_columns.hpp"
+#include "record_file.hpp"
+
+/*
+A Record row is 28 bytes: name[16], id, score, age. A query such as
+"average score of people aged 30 to 40" needs 6 of them, yet a row scan
+pulls every byte of every row through the caches.
+
+The columnar layout (record_columns.hpp) stores each field contiguously per
+row group of 65536 rows. This demo:
+
+1. Converts a row file to columns
+2. Runs the same three aggregates on both layouts and times them
+3. Converts the columns back to rows and checks nothing changed
+
+Interesting facts & pitfalls:
+- The score column is 1/7 of the data, so a scan reads 1/7 of the bytes.
+- Column loops are simple enough for the compiler to use SIMD registers;
+  the row loop has to gather fields 28 bytes apart.
+- Rebuilding a whole row touches 4 columns: point lookups and updates
+  stay cheaper in the row format. Keep both when both kinds of access
+  matter.
+*/
+
+using Clock = std::chrono::steady_clock;
+
+struct Answers {
+    double total_score = 0;
+    std::size_t aged_30_40 = 0;
+    double score_30_40 = 0;
+};
+
+template <class F>
+double best_ms(F f) {
+    double best = 1e30;
+    for (int rep = 0; rep < 5; ++rep) {
+        auto t0 = Clock::now();
+        f();
+        best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+    }
+    return best;
+}
+
+int main(int argc, char* argv[]) {
+    std::string rows_path = (argc > 1) ? argv[1] : "records_rows.bin";
+    const std::string cols_path = "records_cols.bin";
+    const std::string back_path = "records_back.bin";
+
+    if (argc < 2) {
+        std::mt19937 gen(5);
+        std::vector<Record> recs(10000000);
+        for (std::size_t i = 0; i < recs.size(); ++i) {
+            std::snprintf(recs[i].name, sizeof(recs[i].name), "user%u", static_cast<unsigned>(i));
+            recs[i].id = static_cast<std::uint32_t>(gen());
+            recs[i].score = static_cast<float>(gen() % 10000) / 100.0f;
+            recs[i].age = static_cast<std::uint16_t>(18 + gen() % 60);
+        }
+        RecordFile out;
+        if (!out.open(rows_path) || !out.append(recs.data(), recs.size()) || !out.close()) {
+            std::perror("Error: Cannot write records_rows.bin");
+            return 1;
+        }
+    }
+
+    // --------------------------------------------------------------------
+    // 1. Rows -> columns
+    // --------------------------------------------------------------------
+    RecordFile rows;
+    if (!rows.open(rows_path, false)) {
+        std::perror(rows_path.c_str());
+        return 1;
+    }
+    std::cout << "=== Step 1: Converting " << rows.size() << " rows to columns ===\n";
+    if (!columns::write_columns(cols_path, rows.data(), rows.size())) {
+        std::perror("Error: Cannot write records_cols.bin");
+        return 1;
+    }
+    columns::ColumnFile cols;
+    if (!cols.open(cols_path)) {
+        std::perror("Error: Cannot open records_cols.bin");
+        return 1;
+    }
+    std::cout << cols.groups() << " row groups of " << cols.group_rows() << " rows\n\n";
+
+    // --------------------------------------------------------------------
+    // 2. Same aggregates, both layouts
+    // --------------------------------------------------------------------
+    std::cout << "=== Step 2: sum(score), count(age 30..40), sum(score | age 30..40) ===\n";
+    Answers by_row, by_col;
+    double row_ms = best_ms([&] {
+        by_row = Answers{};
+        for (const Record& r : rows) {
+            by_row.total_score += r.score;
+            bool hit = r.age >= 30 && r.age <= 40;
+            by_row.aged_30_40 += hit;
+            by_row.score_30_40 += hit ? r.score : 0.0f;
+        }
+    });
+    double col_ms = best_ms([&] {
+        by_col = Answers{};
+        for (std::size_t g = 0; g < cols.groups(); ++g) {
+            const std::size_t n = cols.rows_in(g);
+            by_col.total_score += columns::sum(cols.score(g), n);
+            by_col.aged_30_40 += columns::count_between(cols.age(g), n, 30, 40);
+            by_col.score_30_40 += columns::sum_where_between(cols.score(g), cols.age(g), n, 30, 40);
+        }
+    });
+    std::cout << "row scan:    " << row_ms << " ms\n"
+              << "column scan: " << col_ms << " ms\n"
+              << "average score at 30..40: " << by_col.score_30_40 / by_col.aged_30_40
+              << " over " << by_col.aged_30_40 << " people\n";
+    // The column kernels add in float blocks, in another order: allow rounding.
+    bool same = by_row.aged_30_40 == by_col.aged_30_40 &&
+                std::fabs(by_row.total_score - by_col.total_score) <= 1e-6 * std::fabs(by_row.total_score) &&
+                std::fabs(by_row.score_30_40 - by_col.score_30_40) <= 1e-6 * std::fabs(by_row.score_30_40);
+    std::cout << (same ? "same answers\n\n" : "ANSWERS DIFFER!\n\n");
+
+    // --------------------------------------------------------------------
+    // 3. Columns -> rows
+    // --------------------------------------------------------------------
+    std::cout << "=== Step 3: Converting back to rows ===\n";
+    if (!cols.write_rows(back_path)) {
+        std::perror("Error: Cannot write records_back.bin");
+        return 1;
+    }
+    RecordFile back;
+    back.open(back_path, false);
+    bool equal = back.size() == rows.size();
+    for (std::size_t i = 0; equal && i < rows.size(); ++i)
+        equal = std::memcmp(rows[i].name, back[i].name, 16) == 0 && rows[i].id == back[i].id &&
+                rows[i].score == back[i].score && rows[i].age == back[i].age;
+    std::cout << (equal ? "round trip is exact\n" : "ROUND TRIP DIFFERS!\n");
+    back.close();
+
+    std::remove(cols_path.c_str());
+    std::remove(back_path.c_str());
+    if (argc < 2) std::remove(rows_path.c_str());
+    return (same && equal) ? 0 : 1;
+}
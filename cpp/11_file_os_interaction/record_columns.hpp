@@ -0,0 +1,296 @@
+// record_columns.hpp
+// A columnar file layout for Record (see record.hpp), with converters from
+// and to the row format and scan kernels over single columns.
+//
+// The file is split into row groups of group_rows rows (the last one may be
+// shorter). Inside a group every field is one contiguous array:
+//
+//   offset 0                       64-byte ColumnHeader
+//   group g at 64 + g * stride     name[16] * n | id * n | score * n | age * n
+//
+// Each column chunk starts on a 64-byte boundary and every group takes the
+// space of a full one (stride), so any column of any group is found by
+// arithmetic. Summing score over the file then touches 4 of the 28 bytes
+// of each row, and the loops below run over plain float / uint16_t arrays
+// that the compiler vectorizes.
+//
+// Values are stored in host byte order; the header records it and open()
+// refuses a file written with the other one (see record_format.hpp for the
+// portable row format).
+
+#ifndef RECORD_COLUMNS_HPP
+#define RECORD_COLUMNS_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "record.hpp"
+
+namespace columns {
+
+constexpr std::size_t default_group_rows = 65536;
+constexpr std::uint32_t byte_order_tag = 0x01020304;
+
+struct ColumnHeader {
+    char magic[8] = {'R', 'E', 'C', 'C', 'O', 'L', 'S', '\n'};
+    std::uint32_t version = 1;
+    std::uint32_t byte_order = byte_order_tag;  // reads 0x04030201 on the other byte order
+    std::uint64_t row_count = 0;
+    std::uint64_t group_rows = 0;
+    std::uint8_t reserved[32] = {};
+};
+static_assert(sizeof(ColumnHeader) == 64, "the header fills one cache line");
+
+inline std::size_t align64(std::size_t n) { return (n + 63) & ~std::size_t(63); }
+
+// Byte offsets of the four column chunks inside a group of n rows.
+struct GroupLayout {
+    std::size_t name, id, score, age, bytes;
+    explicit GroupLayout(std::size_t n)
+        : name(0),
+          id(align64(16 * n)),
+          score(id + align64(4 * n)),
+          age(score + align64(4 * n)),
+          bytes(age + align64(2 * n)) {}
+};
+
+// ----------------------------------------------------------------------------
+// Row -> column conversion
+// ----------------------------------------------------------------------------
+
+// Writes recs[0, n) as a column file. One group is transposed in memory at
+// a time, so the source can be a mapped file of any size.
+inline bool write_columns(const std::string& path, const Record* recs, std::size_t n,
+                          std::size_t group_rows = default_group_rows) {
+    group_rows = std::max<std::size_t>(group_rows, 1);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return false;
+    ColumnHeader h;
+    h.row_count = n;
+    h.group_rows = group_rows;
+    bool ok = ::pwrite(fd, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h));
+
+    const GroupLayout full(group_rows);
+    std::vector<unsigned char> buf(full.bytes);
+    for (std::size_t first = 0; ok && first < n; first += group_rows) {
+        const std::size_t rows = std::min(group_rows, n - first);
+        std::fill(buf.begin(), buf.end(), 0);
+        const GroupLayout g(rows);
+        char* name = reinterpret_cast<char*>(buf.data() + g.name);
+        std::uint32_t* id = reinterpret_cast<std::uint32_t*>(buf.data() + g.id);
+        float* score = reinterpret_cast<float*>(buf.data() + g.score);
+        std::uint16_t* age = reinterpret_cast<std::uint16_t*>(buf.data() + g.age);
+        for (std::size_t i = 0; i < rows; ++i) {
+            const Record& r = recs[first + i];
+            std::memcpy(name + 16 * i, r.name, 16);
+            id[i] = r.id;
+            score[i] = r.score;
+            age[i] = r.age;
+        }
+        off_t at = static_cast<off_t>(sizeof(h) + first / group_rows * full.bytes);
+        ok = ::pwrite(fd, buf.data(), g.bytes, at) == static_cast<ssize_t>(g.bytes);
+    }
+    return (::close(fd) == 0) && ok;
+}
+
+// ----------------------------------------------------------------------------
+// Reading
+// ----------------------------------------------------------------------------
+
+class ColumnFile {
+public:
+    ColumnFile() = default;
+    ~ColumnFile() { close(); }
+    ColumnFile(const ColumnFile&) = delete;
+    ColumnFile& operator=(const ColumnFile&) = delete;
+
+    // Maps the file read-only; errno is EINVAL for a file of the wrong
+    // format or byte order.
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(ColumnHeader)) {
+            ::close(fd);
+            errno = EINVAL;
+            return false;
+        }
+        bytes_ = static_cast<std::size_t>(st.st_size);
+        void* p = ::mmap(nullptr, bytes_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        base_ = static_cast<const unsigned char*>(p);
+        std::memcpy(&h_, base_, sizeof(h_));
+        const ColumnHeader expected;
+        if (std::memcmp(h_.magic, expected.magic, sizeof(h_.magic)) != 0 || h_.version != 1 ||
+            h_.byte_order != byte_order_tag || h_.group_rows == 0 || !groups_fit()) {
+            close();
+            errno = EINVAL;
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (base_ != nullptr) ::munmap(const_cast<unsigned char*>(base_), bytes_);
+        base_ = nullptr;
+        bytes_ = 0;
+        h_ = ColumnHeader();
+    }
+
+    std::size_t rows() const { return h_.row_count; }
+    std::size_t group_rows() const { return h_.group_rows; }
+    std::size_t groups() const { return h_.row_count / h_.group_rows + (h_.row_count % h_.group_rows != 0); }
+    std::size_t rows_in(std::size_t g) const {
+        return std::min<std::size_t>(h_.group_rows, h_.row_count - g * h_.group_rows);
+    }
+
+    // Column chunks of group g, rows_in(g) values each.
+    const char* name(std::size_t g) const { return chunk<char>(g, &GroupLayout::name); }
+    const std::uint32_t* id(std::size_t g) const { return chunk<std::uint32_t>(g, &GroupLayout::id); }
+    const float* score(std::size_t g) const { return chunk<float>(g, &GroupLayout::score); }
+    const std::uint16_t* age(std::size_t g) const { return chunk<std::uint16_t>(g, &GroupLayout::age); }
+
+    // Gathers row i back from the four columns.
+    Record row(std::size_t i) const {
+        std::size_t g = i / h_.group_rows, k = i % h_.group_rows;
+        Record r;
+        std::memcpy(r.name, name(g) + 16 * k, 16);
+        r.id = id(g)[k];
+        r.score = score(g)[k];
+        r.age = age(g)[k];
+        return r;
+    }
+
+    // Column -> row conversion: writes every row, in order, to path.
+    bool write_rows(const std::string& path) const {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return false;
+        std::vector<Record> buf;
+        bool ok = true;
+        for (std::size_t g = 0; ok && g < groups(); ++g) {
+            const std::size_t n = rows_in(g);
+            buf.resize(n);
+            const char* nm = name(g);
+            const std::uint32_t* ids = id(g);
+            const float* sc = score(g);
+            const std::uint16_t* ag = age(g);
+            for (std::size_t k = 0; k < n; ++k) {
+                std::memset(&buf[k], 0, sizeof(Record));  // no stray padding bytes in the file
+                std::memcpy(buf[k].name, nm + 16 * k, 16);
+                buf[k].id = ids[k];
+                buf[k].score = sc[k];
+                buf[k].age = ag[k];
+            }
+            const std::size_t bytes = n * sizeof(Record);
+            ok = ::write(fd, buf.data(), bytes) == static_cast<ssize_t>(bytes);
+        }
+        return (::close(fd) == 0) && ok;
+    }
+
+private:
+    const unsigned char* base_ = nullptr;
+    std::size_t bytes_ = 0;
+    ColumnHeader h_;
+
+    std::size_t group_offset(std::size_t g) const {
+        return sizeof(ColumnHeader) + g * GroupLayout(h_.group_rows).bytes;
+    }
+    // Every group lies inside the file. The header comes from the file, so
+    // nothing is added or multiplied before it is known not to overflow: a
+    // row takes at least 26 bytes, which bounds row_count and group_rows,
+    // and the group offsets are compared by division and differences.
+    bool groups_fit() const {
+        if (h_.row_count == 0) return true;
+        const std::size_t avail = bytes_ - sizeof(ColumnHeader);
+        if (h_.row_count > avail / (16 + 4 + 4 + 2)) return false;
+        const std::size_t last = groups() - 1;
+        if (last == 0) return GroupLayout(h_.row_count).bytes <= avail;
+        const std::size_t full = GroupLayout(h_.group_rows).bytes;  // group_rows < row_count
+        return last <= avail / full && GroupLayout(rows_in(last)).bytes <= avail - last * full;
+    }
+    template <class T>
+    const T* chunk(std::size_t g, std::size_t GroupLayout::*field) const {
+        return reinterpret_cast<const T*>(base_ + group_offset(g) + GroupLayout(rows_in(g)).*field);
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Column kernels
+// ----------------------------------------------------------------------------
+// Each kernel works on 8 lanes at a time with independent accumulators and
+// no branches: straight-line lane code is what GCC turns into SIMD even at
+// -O2 (check with -fopt-info-vec), and without -ffast-math it may not
+// reorder a single running sum itself. Sums run in float lanes over blocks
+// of kernel_block values and then go into a double, keeping the vector
+// width of float and most of the precision of double.
+
+constexpr std::size_t kernel_block = 512;
+constexpr std::size_t lanes = 8;
+
+inline double sum(const float* v, std::size_t n) {
+    double total = 0;
+    std::size_t i = 0;
+    while (i + lanes <= n) {
+        float acc[lanes] = {};
+        const std::size_t end = std::min(n - n % lanes, i + kernel_block);
+        for (; i < end; i += lanes)
+            for (std::size_t l = 0; l < lanes; ++l) acc[l] += v[i + l];
+        for (float a : acc) total += a;
+    }
+    for (; i < n; ++i) total += v[i];
+    return total;
+}
+
+inline std::size_t count_between(const std::uint16_t* v, std::size_t n,
+                                 std::uint16_t lo, std::uint16_t hi) {
+    if (lo > hi) return 0;  // hi - lo would wrap around to a huge width
+    const std::uint16_t width = static_cast<std::uint16_t>(hi - lo);
+    std::size_t count = 0;
+    std::size_t i = 0;
+    while (i + lanes <= n) {
+        std::uint16_t acc[lanes] = {};  // 8 x 16 bits: one SSE register
+        const std::size_t end = std::min(n - n % lanes, i + kernel_block);
+        for (; i < end; i += lanes)
+            for (std::size_t l = 0; l < lanes; ++l)
+                acc[l] += static_cast<std::uint16_t>(v[i + l] - lo) <= width;
+        for (std::uint16_t a : acc) count += a;
+    }
+    for (; i < n; ++i) count += static_cast<std::uint16_t>(v[i] - lo) <= width;
+    return count;
+}
+
+// Sum of score over the rows whose age is in [lo, hi]: the test becomes a
+// 0 / 1 factor instead of a branch (so scores must be finite: inf * 0 is NaN).
+inline double sum_where_between(const float* score, const std::uint16_t* age, std::size_t n,
+                                std::uint16_t lo, std::uint16_t hi) {
+    if (lo > hi) return 0.0;
+    const std::uint16_t width = static_cast<std::uint16_t>(hi - lo);
+    double total = 0;
+    std::size_t i = 0;
+    while (i + lanes <= n) {
+        float acc[lanes] = {};
+        const std::size_t end = std::min(n - n % lanes, i + kernel_block);
+        for (; i < end; i += lanes)
+            for (std::size_t l = 0; l < lanes; ++l)
+                acc[l] += score[i + l] * static_cast<float>(static_cast<std::uint16_t>(age[i + l] - lo) <= width);
+        for (float a : acc) total += a;
+    }
+    for (; i < n; ++i)
+        if (static_cast<std::uint16_t>(age[i] - lo) <= width) total += score[i];
+    return total;
+}
+
+} // namespace columns
+
+#endif // RECORD_COLUMNS_HPP
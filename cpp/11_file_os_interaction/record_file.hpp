@@ -0,0 +1,192 @@
+// record_file.hpp
+// RecordFile: a Record file (see record.hpp) mapped into memory.
+//
+//   RecordFile f;
+//   if (!f.open("records.bin")) { perror("open"); return 1; }
+//   f[2].score = 100.0f;          // in-place update, no syscall
+//   f.append(r);                  // grows the file geometrically
+//   f.sync(2, 1);                 // msync only the pages of record 2
+//
+// The mapping is MAP_SHARED, so stores through operator[] are stores into
+// the page cache: other processes mapping or reading the file see them at
+// once, and the kernel writes them back later (or at sync()).
+//
+// Appending grows the file with ftruncate() to twice its capacity and maps
+// it again, so n appends cost O(log n) remaps. Between open() and close()
+// the file on disk can therefore be longer than size() records, with zeroed
+// records at the end; close() truncates it back. Every growth may move the
+// mapping: pointers and references into the file are invalidated by
+// append() and reserve(), like std::vector iterators.
+//
+// Errors are reported by returning false with errno set by the failing call.
+
+#ifndef RECORD_FILE_HPP
+#define RECORD_FILE_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "record.hpp"
+
+class RecordFile {
+public:
+    RecordFile() = default;
+    ~RecordFile() { close(); }
+    RecordFile(const RecordFile&) = delete;
+    RecordFile& operator=(const RecordFile&) = delete;
+    RecordFile(RecordFile&& o) noexcept { swap(o); }
+    RecordFile& operator=(RecordFile&& o) noexcept {
+        if (this != &o) {
+            close();
+            swap(o);
+        }
+        return *this;
+    }
+
+    // Maps path; a writable file is created if it does not exist.
+    // A trailing partial record (file size not a multiple of 28) is not part
+    // of size() and is left alone until the file grows: the first append()
+    // or reserve() overwrites it, and close() then truncates it away.
+    bool open(const std::string& path, bool writable = true) {
+        close();
+        fd_ = ::open(path.c_str(), writable ? (O_RDWR | O_CREAT) : O_RDONLY, 0644);
+        if (fd_ < 0) return false;
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            close();
+            return false;
+        }
+        writable_ = writable;
+        count_ = static_cast<std::size_t>(st.st_size) / sizeof(Record);
+        file_bytes_ = static_cast<std::size_t>(st.st_size);
+        if (!map(count_)) {
+            int err = errno;
+            close();
+            errno = err;
+            return false;
+        }
+        return true;
+    }
+
+    // Unmaps and, for a writable file, truncates the growth slack away.
+    // Does not msync: call sync() first when durability matters.
+    bool close() {
+        bool ok = true;
+        if (data_ != nullptr) ::munmap(data_, capacity_ * sizeof(Record));
+        if (fd_ >= 0) {
+            if (grown_ && file_bytes_ != count_ * sizeof(Record))
+                ok = ::ftruncate(fd_, static_cast<off_t>(count_ * sizeof(Record))) == 0;
+            ok = (::close(fd_) == 0) && ok;
+        }
+        fd_ = -1;
+        data_ = nullptr;
+        count_ = capacity_ = file_bytes_ = 0;
+        writable_ = grown_ = false;
+        return ok;
+    }
+
+    bool is_open() const { return fd_ >= 0; }
+    bool writable() const { return writable_; }
+
+    // Span-like view of the records. Writing through a read-only file is a
+    // segmentation fault, as for any PROT_READ mapping.
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    std::size_t capacity() const { return capacity_; }
+    Record* data() { return data_; }
+    const Record* data() const { return data_; }
+    Record& operator[](std::size_t i) { return data_[i]; }
+    const Record& operator[](std::size_t i) const { return data_[i]; }
+    Record* begin() { return data_; }
+    Record* end() { return data_ + count_; }
+    const Record* begin() const { return data_; }
+    const Record* end() const { return data_ + count_; }
+
+    // Makes room for n records without changing size().
+    bool reserve(std::size_t n) {
+        if (n <= capacity_) return true;
+        if (!writable_) {
+            errno = EBADF;
+            return false;
+        }
+        if (::ftruncate(fd_, static_cast<off_t>(n * sizeof(Record))) != 0) return false;
+        file_bytes_ = n * sizeof(Record);
+        grown_ = true;
+        // The new mapping is made before the old one goes away, so on
+        // failure the file stays usable at its old capacity.
+        Record* old = data_;
+        std::size_t old_capacity = capacity_;
+        if (!map(n)) return false;
+        if (old != nullptr) ::munmap(old, old_capacity * sizeof(Record));
+        return true;
+    }
+
+    bool append(const Record& r) { return append(&r, 1); }
+
+    bool append(const Record* recs, std::size_t n) {
+        if (count_ + n > capacity_ &&
+            !reserve(std::max({count_ + n, 2 * capacity_, MinCapacity})))
+            return false;
+        std::memcpy(data_ + count_, recs, n * sizeof(Record));
+        count_ += n;
+        return true;
+    }
+
+    // Writes back the pages holding records [first, first + n). With
+    // wait = false the writeback is only scheduled (MS_ASYNC).
+    bool sync(std::size_t first, std::size_t n, bool wait = true) {
+        if (data_ == nullptr || n == 0 || first >= count_) return true;
+        n = std::min(n, count_ - first);
+        static const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        std::size_t begin = first * sizeof(Record) / page * page;  // msync wants page alignment
+        std::size_t end = (first + n) * sizeof(Record);
+        return ::msync(reinterpret_cast<char*>(data_) + begin, end - begin,
+                       wait ? MS_SYNC : MS_ASYNC) == 0;
+    }
+
+    bool sync(bool wait = true) { return sync(0, count_, wait); }
+
+    // Smallest capacity after the first append, in records (about 1 MiB).
+    static constexpr std::size_t MinCapacity = (std::size_t(1) << 20) / sizeof(Record);
+
+private:
+    int fd_ = -1;
+    Record* data_ = nullptr;
+    std::size_t count_ = 0;       // records in use
+    std::size_t capacity_ = 0;    // records mapped
+    std::size_t file_bytes_ = 0;  // current length of the file on disk
+    bool writable_ = false;
+    bool grown_ = false;          // file was extended by reserve()
+
+    // Maps the first n records of the file (nothing for n = 0: mmap refuses
+    // empty mappings).
+    bool map(std::size_t n) {
+        if (n == 0) return true;
+        int prot = writable_ ? (PROT_READ | PROT_WRITE) : PROT_READ;
+        void* p = ::mmap(nullptr, n * sizeof(Record), prot, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) return false;
+        data_ = static_cast<Record*>(p);
+        capacity_ = n;
+        return true;
+    }
+
+    void swap(RecordFile& o) noexcept {
+        std::swap(fd_, o.fd_);
+        std::swap(data_, o.data_);
+        std::swap(count_, o.count_);
+        std::swap(capacity_, o.capacity_);
+        std::swap(file_bytes_, o.file_bytes_);
+        std::swap(writable_, o.writable_);
+        std::swap(grown_, o.grown_);
+    }
+};
+
+#endif // RECORD_FILE_HPP
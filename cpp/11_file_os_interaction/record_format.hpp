@@ -0,0 +1,272 @@
+// record_format.hpp
+// A portable, versioned file format for Record (see record.hpp).
+//
+// The raw Record files of serialization.cpp are a memory dump: their layout
+// depends on the compiler's padding and on the byte order of the machine.
+// Here every byte is specified instead:
+//
+//   offset  size  content
+//   0       64    FileHeader (magic, version, sizes, record count, schema hash)
+//   64      16*n  FieldDesc table, one entry per field (name, type, offset)
+//   data    28*k  records, all fields little-endian at fixed offsets:
+//                   0  name   16 bytes, zero-padded
+//                   16 id     uint32
+//                   20 score  float32 (IEEE 754 bits)
+//                   24 age    uint16
+//                   26 (2 reserved zero bytes, keep 4-byte fields aligned)
+//
+// On a little-endian host this is exactly the in-memory Record of x86-64
+// and AArch64 GCC/Clang, so each accessor below compiles to a single load,
+// like the reinterpret_cast path. On a big-endian host the same code
+// assembles the bytes in order, which is slower but correct.
+//
+// RecordView / RecordSlot read and write fields in place, from a mapped
+// file or any byte buffer; to_record() / from_record() convert to the native
+// struct. The schema hash covers the field table, so a reader built for
+// another layout refuses the file instead of misreading it.
+
+#ifndef RECORD_FORMAT_HPP
+#define RECORD_FORMAT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include "record.hpp"
+
+namespace recfmt {
+
+// ----------------------------------------------------------------------------
+// Little-endian loads and stores
+// ----------------------------------------------------------------------------
+
+// C++17 has no std::endian yet; GCC and Clang predefine the byte order.
+// Define RECFMT_PORTABLE to force the byte-by-byte path (for testing it on
+// a little-endian machine).
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__ && !defined(RECFMT_PORTABLE)
+constexpr bool host_is_little_endian = true;
+#else
+constexpr bool host_is_little_endian = false;
+#endif
+
+template <class T>
+T load_le(const unsigned char* p) {
+    static_assert(std::is_arithmetic<T>::value, "load_le reads numbers");
+    using U = std::conditional_t<sizeof(T) == 8, std::uint64_t,
+              std::conditional_t<sizeof(T) == 4, std::uint32_t,
+              std::conditional_t<sizeof(T) == 2, std::uint16_t, std::uint8_t>>>;
+    U u = 0;
+    if constexpr (host_is_little_endian) {
+        std::memcpy(&u, p, sizeof(U));  // one unaligned-safe load
+    } else {
+        for (std::size_t i = 0; i < sizeof(U); ++i)
+            u |= static_cast<U>(static_cast<U>(p[i]) << (8 * i));
+    }
+    T v;
+    std::memcpy(&v, &u, sizeof(T));  // float bits are reinterpreted, not converted
+    return v;
+}
+
+template <class T>
+void store_le(unsigned char* p, T v) {
+    static_assert(std::is_arithmetic<T>::value, "store_le writes numbers");
+    using U = std::conditional_t<sizeof(T) == 8, std::uint64_t,
+              std::conditional_t<sizeof(T) == 4, std::uint32_t,
+              std::conditional_t<sizeof(T) == 2, std::uint16_t, std::uint8_t>>>;
+    U u;
+    std::memcpy(&u, &v, sizeof(T));
+    if constexpr (host_is_little_endian) {
+        std::memcpy(p, &u, sizeof(U));
+    } else {
+        for (std::size_t i = 0; i < sizeof(U); ++i)
+            p[i] = static_cast<unsigned char>(u >> (8 * i));
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Schema
+// ----------------------------------------------------------------------------
+
+enum class FieldType : std::uint8_t { Bytes = 1, UInt16 = 2, UInt32 = 3, Float32 = 4 };
+
+// One entry of the on-disk field table (16 bytes).
+struct FieldDesc {
+    char name[8];
+    std::uint16_t offset;
+    std::uint16_t size;
+    FieldType type;
+};
+
+constexpr std::uint16_t current_version = 1;
+constexpr std::size_t header_size = 64;
+constexpr std::size_t field_desc_size = 16;
+constexpr std::size_t record_size = 28;
+
+constexpr FieldDesc fields[] = {
+    {"name",  0,  16, FieldType::Bytes},
+    {"id",    16, 4,  FieldType::UInt32},
+    {"score", 20, 4,  FieldType::Float32},
+    {"age",   24, 2,  FieldType::UInt16},
+};
+constexpr std::size_t field_count = sizeof(fields) / sizeof(fields[0]);
+constexpr std::size_t data_offset = header_size + field_count * field_desc_size;
+
+// FNV-1a over the serialized field table: any renamed, moved, resized or
+// retyped field changes it.
+constexpr std::uint64_t fnv1a(std::uint64_t h, std::uint64_t byte) {
+    return (h ^ (byte & 0xff)) * 0x100000001b3ULL;
+}
+constexpr std::uint64_t schema_hash_of(const FieldDesc* f, std::size_t n) {
+    std::uint64_t h = 0xcbf29ce484222325ULL;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t c = 0; c < sizeof(f[i].name); ++c)
+            h = fnv1a(h, static_cast<unsigned char>(f[i].name[c]));
+        h = fnv1a(fnv1a(h, f[i].offset), f[i].offset >> 8);
+        h = fnv1a(fnv1a(h, f[i].size), f[i].size >> 8);
+        h = fnv1a(h, static_cast<std::uint8_t>(f[i].type));
+    }
+    return h;
+}
+constexpr std::uint64_t schema_hash = schema_hash_of(fields, field_count);
+
+// Decoded header. On disk: magic at 0, version 8, field_count 10,
+// record_size 12, data_offset 16, record_count 24, schema_hash 32, zeros up
+// to 64. A FieldDesc is stored as name 0, offset 8, size 10, type 12.
+struct FileHeader {
+    std::uint16_t version = current_version;
+    std::uint16_t field_count = 0;
+    std::uint32_t record_size = 0;
+    std::uint64_t data_offset = 0;
+    std::uint64_t record_count = 0;
+    std::uint64_t schema_hash = 0;
+};
+
+constexpr char magic[8] = {'R', 'E', 'C', 'F', 'M', 'T', '\r', '\n'};  // \r\n catches text-mode mangling
+
+inline void write_header(unsigned char* out, std::uint64_t record_count) {
+    std::memset(out, 0, data_offset);
+    std::memcpy(out, magic, sizeof(magic));
+    store_le<std::uint16_t>(out + 8, current_version);
+    store_le<std::uint16_t>(out + 10, static_cast<std::uint16_t>(field_count));
+    store_le<std::uint32_t>(out + 12, record_size);
+    store_le<std::uint64_t>(out + 16, data_offset);
+    store_le<std::uint64_t>(out + 24, record_count);
+    store_le<std::uint64_t>(out + 32, schema_hash);
+    for (std::size_t i = 0; i < field_count; ++i) {
+        unsigned char* d = out + header_size + i * field_desc_size;
+        std::memcpy(d, fields[i].name, sizeof(fields[i].name));
+        store_le<std::uint16_t>(d + 8, fields[i].offset);
+        store_le<std::uint16_t>(d + 10, fields[i].size);
+        d[12] = static_cast<unsigned char>(fields[i].type);
+    }
+}
+
+enum class Status { Ok, TooSmall, BadMagic, NewerVersion, SchemaMismatch, Truncated };
+
+inline const char* to_string(Status s) {
+    switch (s) {
+        case Status::Ok:             return "ok";
+        case Status::TooSmall:       return "file is smaller than the header";
+        case Status::BadMagic:       return "not a record file (bad magic)";
+        case Status::NewerVersion:   return "written by a newer format version";
+        case Status::SchemaMismatch: return "field layout differs from this reader";
+        case Status::Truncated:      return "file is shorter than its record count";
+    }
+    return "unknown";
+}
+
+// Checks a whole file image (e.g. a mapping) of `bytes` bytes.
+inline Status read_header(const unsigned char* in, std::size_t bytes, FileHeader& h) {
+    if (bytes < header_size) return Status::TooSmall;
+    if (std::memcmp(in, magic, sizeof(magic)) != 0) return Status::BadMagic;
+    h.version = load_le<std::uint16_t>(in + 8);
+    h.field_count = load_le<std::uint16_t>(in + 10);
+    h.record_size = load_le<std::uint32_t>(in + 12);
+    h.data_offset = load_le<std::uint64_t>(in + 16);
+    h.record_count = load_le<std::uint64_t>(in + 24);
+    h.schema_hash = load_le<std::uint64_t>(in + 32);
+    if (h.version > current_version) return Status::NewerVersion;
+    if (h.schema_hash != schema_hash || h.record_size != record_size ||
+        h.field_count != field_count || h.data_offset != data_offset)
+        return Status::SchemaMismatch;
+    if (bytes < data_offset || (bytes - data_offset) / record_size < h.record_count)
+        return Status::Truncated;
+    return Status::Ok;
+}
+
+// ----------------------------------------------------------------------------
+// In-place accessors
+// ----------------------------------------------------------------------------
+
+// Read-only view of one encoded record. Holds a pointer, copy it freely.
+class RecordView {
+public:
+    explicit RecordView(const unsigned char* p) : p_(p) {}
+
+    std::string_view name() const {
+        const char* s = reinterpret_cast<const char*>(p_);
+        return std::string_view(s, ::strnlen(s, 16));
+    }
+    std::uint32_t id() const { return load_le<std::uint32_t>(p_ + 16); }
+    float score() const { return load_le<float>(p_ + 20); }
+    std::uint16_t age() const { return load_le<std::uint16_t>(p_ + 24); }
+
+    Record to_record() const {
+        Record r{};
+        std::string_view n = name();
+        std::memcpy(r.name, n.data(), n.size());
+        r.id = id();
+        r.score = score();
+        r.age = age();
+        return r;
+    }
+
+protected:
+    const unsigned char* p_;
+};
+
+// Writable view: setters store straight into the buffer (or MAP_SHARED file).
+class RecordSlot : public RecordView {
+public:
+    explicit RecordSlot(unsigned char* p) : RecordView(p), w_(p) {}
+
+    void set_name(std::string_view n) {
+        unsigned char* p = w_;
+        std::size_t len = n.size() < 16 ? n.size() : 16;
+        std::memcpy(p, n.data(), len);
+        std::memset(p + len, 0, 16 - len);
+    }
+    void set_id(std::uint32_t v) { store_le(w_ + 16, v); }
+    void set_score(float v) { store_le(w_ + 20, v); }
+    void set_age(std::uint16_t v) { store_le(w_ + 24, v); }
+
+    void from_record(const Record& r) {
+        set_name(std::string_view(r.name, ::strnlen(r.name, 16)));
+        set_id(r.id);
+        set_score(r.score);
+        set_age(r.age);
+        w_[26] = w_[27] = 0;
+    }
+
+private:
+    unsigned char* w_;
+};
+
+// The records of a checked file image: records(base)[i] is record i.
+class RecordArray {
+public:
+    RecordArray(const unsigned char* base, std::size_t count)
+        : data_(base + data_offset), count_(count) {}
+    std::size_t size() const { return count_; }
+    RecordView operator[](std::size_t i) const { return RecordView(data_ + i * record_size); }
+
+private:
+    const unsigned char* data_;
+    std::size_t count_;
+};
+
+} // namespace recfmt
+
+#endif // RECORD_FORMAT_HPP
@@ -0,0 +1,171 @@
+// record_wal.cpp
+// Complete C++17 tutorial and demo: durable Record updates with a write-ahead log
+// Compile: g++ -std=c++17 -Wall -Wextra -O2 -pthread record_wal.cpp -o record_wal
+// Run: ./record_wal [seconds per test]     (default 1)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "record_wal.hpp"
+
+/*
+serialization.cpp updates record i with seekp(i * sizeof(Record)) + write +
+flush. flush() only hands the bytes to the kernel: a crash can lose the
+update, and a power cut in the middle can leave half an old and half a new
+record on disk. Adding fsync() after every write fixes that, at the price
+of one disk flush per update: a few hundred per second on most disks.
+
+RecordWal (record_wal.hpp) instead:
+1. Appends each change as a checksummed entry to a sequential log
+2. Shares one fdatasync() among all threads committing at the same time
+3. Copies the changes into the data file at checkpoints, and replays the
+   log after a crash
+
+This demo measures both approaches, then kills a process that has
+acknowledged updates without checkpointing, and recovers them.
+
+Interesting facts & pitfalls:
+- Group commit only helps when several threads commit concurrently: a single
+  thread still waits for its own flush each time.
+- On tmpfs or with a battery-backed cache, fdatasync() is nearly free and
+  both approaches look fast; try the demo on a real disk.
+- The checksum is what tells a half-written last entry apart from a real
+  one; the epoch in each entry tells old entries apart after a checkpoint.
+*/
+
+using Clock = std::chrono::steady_clock;
+
+Record make_record(std::uint64_t i, std::uint32_t version) {
+    Record r{};
+    std::snprintf(r.name, sizeof(r.name), "rec%llu", static_cast<unsigned long long>(i));
+    r.id = static_cast<std::uint32_t>(i);
+    r.score = static_cast<float>(version);
+    r.age = static_cast<std::uint16_t>(version % 100);
+    return r;
+}
+
+int main(int argc, char* argv[]) {
+    const double seconds = (argc > 1) ? std::stod(argv[1]) : 1.0;
+    const std::string data = "records_wal.bin", log = "records_wal.log";
+    const std::uint64_t records = 100000;
+    std::remove(data.c_str());
+    std::remove(log.c_str());
+
+    {
+        std::vector<Record> initial(records);
+        for (std::uint64_t i = 0; i < records; ++i) initial[i] = make_record(i, 0);
+        int fd = ::open(data.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0 || ::write(fd, initial.data(), records * sizeof(Record)) < 0 || ::fsync(fd) != 0) {
+            std::perror("Error: Cannot write records_wal.bin");
+            return 1;
+        }
+        ::close(fd);
+    }
+
+    // --------------------------------------------------------------------
+    // 1. Baseline: pwrite + fdatasync per update
+    // --------------------------------------------------------------------
+    std::cout << "=== Step 1: pwrite + fdatasync per update ===\n";
+    {
+        int fd = ::open(data.c_str(), O_RDWR);
+        std::uint64_t done = 0;
+        auto t0 = Clock::now();
+        while (std::chrono::duration<double>(Clock::now() - t0).count() < seconds) {
+            Record r = make_record(done % records, 1);
+            if (::pwrite(fd, &r, sizeof(r), static_cast<off_t>(done % records * sizeof(Record))) < 0 ||
+                ::fdatasync(fd) != 0) {
+                std::perror("Error: pwrite");
+                return 1;
+            }
+            ++done;
+        }
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        std::cout << done / s << " durable updates/s\n\n";
+        ::close(fd);
+    }
+
+    // --------------------------------------------------------------------
+    // 2. WAL with group commit
+    // --------------------------------------------------------------------
+    std::cout << "=== Step 2: WAL group commit ===\n";
+    for (unsigned threads : {1u, 4u, 16u, 64u}) {
+        RecordWal wal;
+        if (!wal.open(data, log)) {
+            std::perror("Error: Cannot open the WAL");
+            return 1;
+        }
+        std::atomic<bool> stop(false);
+        std::atomic<std::uint64_t> done(0);
+        std::vector<std::thread> pool;
+        auto t0 = Clock::now();
+        for (unsigned t = 0; t < threads; ++t)
+            pool.emplace_back([&, t] {
+                for (std::uint64_t k = t; !stop.load(std::memory_order_relaxed); k += threads) {
+                    if (!wal.update(k % records, make_record(k % records, 2))) return;
+                    done.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+        stop = true;
+        for (auto& th : pool) th.join();
+        double s = std::chrono::duration<double>(Clock::now() - t0).count();
+        RecordWal::Stats st = wal.stats();
+        std::cout << threads << " thread(s): " << done / s << " durable updates/s, "
+                  << double(st.commits) / std::max<std::uint64_t>(st.syncs, 1) << " updates per fdatasync\n";
+    }
+    std::cout << "\n";
+
+    // --------------------------------------------------------------------
+    // 3. Crash and recovery
+    // --------------------------------------------------------------------
+    std::cout << "=== Step 3: Crash without checkpoint, then recover ===\n";
+    const std::uint64_t crash_updates = 1000, crash_appends = 10;
+    pid_t child = ::fork();
+    if (child == 0) {
+        RecordWal wal;
+        if (!wal.open(data, log)) ::_exit(1);
+        for (std::uint64_t i = 0; i < crash_updates; ++i)
+            if (!wal.update(i, make_record(i, 3))) ::_exit(1);
+        for (std::uint64_t i = 0; i < crash_appends; ++i)
+            if (wal.append(make_record(records + i, 3)) == RecordWal::no_index) ::_exit(1);
+        // A torn entry at the tail, as if the power failed mid-write.
+        int fd = ::open(log.c_str(), O_WRONLY);
+        const char junk[20] = "half an entry......";
+        ::pwrite(fd, junk, sizeof(junk), 512 + (crash_updates + crash_appends) * 56);
+        ::_exit(0);  // no destructor: no checkpoint
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        std::cerr << "Error: the writer process failed\n";
+        return 1;
+    }
+
+    RecordWal wal;
+    if (!wal.open(data, log)) {
+        std::perror("Error: Recovery failed");
+        return 1;
+    }
+    std::uint64_t ok = 0;
+    Record r;
+    for (std::uint64_t i = 0; i < crash_updates; ++i)
+        ok += wal.read(i, r) && r.score == 3.0f && r.id == i;
+    for (std::uint64_t i = 0; i < crash_appends; ++i)
+        ok += wal.read(records + i, r) && r.score == 3.0f && r.id == records + i;
+    std::cout << "recovered " << ok << " of " << crash_updates + crash_appends
+              << " acknowledged changes, " << wal.size() << " records\n";
+    wal.close();
+
+    std::remove(data.c_str());
+    std::remove(log.c_str());
+    return ok == crash_updates + crash_appends ? 0 : 1;
+}
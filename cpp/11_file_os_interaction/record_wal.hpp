@@ -0,0 +1,393 @@
+// record_wal.hpp
+// RecordWal: durable appends and updates of a Record file through a
+// write-ahead log with group commit.
+//
+//   RecordWal wal;
+//   if (!wal.open("records.bin", "records.wal")) { perror("wal"); return 1; }
+//   wal.update(2, zelda);        // durable when it returns
+//   std::uint64_t i = wal.append(eve);
+//   wal.checkpoint();            // fold the log into records.bin
+//
+// Changes never go to the data file directly. Each one becomes a 56-byte
+// log entry (CRC32C, epoch, type, record index, the whole Record), written
+// sequentially to the log file. Threads that commit at the same time share
+// one write() + fdatasync(): the first one in becomes the leader, flushes
+// every entry queued so far, and wakes the others. One sync then makes a
+// whole batch durable, so the rate grows with the number of writers instead
+// of being capped at one record per disk flush.
+//
+// checkpoint() writes the logged records into the data file with pwrite(),
+// fdatasyncs it, then starts a new log epoch in the log header: older
+// entries are ignored from then on. open() replays the entries of the
+// current epoch, stopping at the first one with a bad checksum (a torn
+// tail), so a crash at any point loses only changes that were not yet
+// acknowledged. Replay is idempotent: every entry names its record index.
+// Records appended to the data file by other code since the last
+// checkpoint are kept: the data file is never truncated.
+//
+// read() and size() see a change only once its log write is durable, so a
+// reader never observes an update that a crash could still take back.
+//
+// Errors are reported by returning false (or no_index) with errno set; after
+// a failed log write or checkpoint the object refuses further commits (EIO)
+// and the log is replayed by the next open(). A commit that triggers an
+// automatic checkpoint is acknowledged even if that checkpoint fails: the
+// change is already durable in the log. stats() counts such failures.
+
+#ifndef RECORD_WAL_HPP
+#define RECORD_WAL_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "record.hpp"
+
+// CRC32C (Castagnoli), table driven.
+inline std::uint32_t crc32c(const void* data, std::size_t n, std::uint32_t crc = 0) {
+    struct Table {
+        std::uint32_t t[256];
+        Table() {
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                std::uint32_t c = i;
+                for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : c >> 1;
+                t[i] = c;
+            }
+        }
+    };
+    static const Table table;
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (std::size_t i = 0; i < n; ++i) crc = table.t[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+class RecordWal {
+public:
+    static constexpr std::uint64_t no_index = ~std::uint64_t(0);
+
+    // Log size that triggers an automatic checkpoint after a commit.
+    explicit RecordWal(std::size_t checkpoint_bytes = std::size_t(64) << 20)
+        : checkpoint_bytes_(checkpoint_bytes) {}
+    ~RecordWal() { close(); }
+    RecordWal(const RecordWal&) = delete;
+    RecordWal& operator=(const RecordWal&) = delete;
+
+    // Opens (or creates) both files and replays the log into the data file.
+    bool open(const std::string& data_path, const std::string& log_path) {
+        close();
+        data_fd_ = ::open(data_path.c_str(), O_RDWR | O_CREAT, 0644);
+        log_fd_ = ::open(log_path.c_str(), O_RDWR | O_CREAT, 0644);
+        struct stat st;
+        if (data_fd_ < 0 || log_fd_ < 0 || ::fstat(data_fd_, &st) != 0) return fail_open();
+
+        LogHeader h;
+        ssize_t got = ::pread(log_fd_, &h, sizeof(h), 0);
+        if (got == 0) {  // new log: the data file is the checkpoint
+            h = LogHeader{};
+            h.data_records = static_cast<std::uint64_t>(st.st_size) / sizeof(Record);
+        } else if (got != static_cast<ssize_t>(sizeof(h)) ||
+                   std::memcmp(h.magic, LogHeader{}.magic, sizeof(h.magic)) != 0 ||
+                   h.crc != header_crc(h)) {
+            errno = EINVAL;
+            return fail_open();
+        }
+        epoch_ = h.epoch;
+        // Records appended behind our back since the checkpoint count too.
+        size_ = std::max<std::uint64_t>(h.data_records, static_cast<std::uint64_t>(st.st_size) / sizeof(Record));
+
+        // Replay the current epoch into the data file, then start a new one.
+        Entry e;
+        off_t at = log_header_bytes;
+        while (::pread(log_fd_, &e, sizeof(e), at) == static_cast<ssize_t>(sizeof(e)) &&
+               e.epoch == epoch_ && (e.type == Append || e.type == Update) &&
+               e.crc == entry_crc(e)) {
+            dirty_[e.index] = e.record;
+            size_ = std::max(size_, e.index + 1);
+            at += sizeof(e);
+        }
+        committed_size_ = size_;
+        std::lock_guard<std::mutex> lock(m_);
+        if (!checkpoint_locked()) return fail_open();
+        return true;
+    }
+
+    // Checkpoints and closes; pending commits must have returned.
+    bool close() {
+        bool ok = true;
+        if (data_fd_ >= 0 && log_fd_ >= 0 && !failed_) {
+            std::unique_lock<std::mutex> lock(m_);
+            cv_.wait(lock, [&] { return !flushing_; });
+            ok = checkpoint_locked();
+        }
+        if (data_fd_ >= 0) ok = (::close(data_fd_) == 0) && ok;
+        if (log_fd_ >= 0) ok = (::close(log_fd_) == 0) && ok;
+        data_fd_ = log_fd_ = -1;
+        dirty_.clear();
+        pending_.clear();
+        size_ = committed_size_ = 0;
+        failed_ = false;
+        return ok;
+    }
+
+    // Number of records with a durable append, checkpointed or not.
+    std::uint64_t size() {
+        std::lock_guard<std::mutex> lock(m_);
+        return committed_size_;
+    }
+
+    // Reads the latest durable version of record i. A change whose append()
+    // or update() has not returned yet is not visible (read committed).
+    bool read(std::uint64_t i, Record& r) {
+        std::lock_guard<std::mutex> lock(m_);
+        if (i >= committed_size_) {
+            errno = ERANGE;
+            return false;
+        }
+        auto it = dirty_.find(i);
+        if (it != dirty_.end()) {
+            r = it->second;
+            return true;
+        }
+        return ::pread(data_fd_, &r, sizeof(r), static_cast<off_t>(i * sizeof(Record))) ==
+               static_cast<ssize_t>(sizeof(r));
+    }
+
+    // Both return once the change is on disk. Safe to call from any thread.
+    std::uint64_t append(const Record& r) {
+        Entry e{};
+        e.type = Append;
+        e.record = r;
+        return commit(e) ? e.index : no_index;
+    }
+
+    bool update(std::uint64_t i, const Record& r) {
+        Entry e{};
+        e.type = Update;
+        e.index = i;
+        e.record = r;
+        return commit(e);
+    }
+
+    // Writes every committed change into the data file and empties the log.
+    bool checkpoint() {
+        std::unique_lock<std::mutex> lock(m_);
+        cv_.wait(lock, [&] { return !flushing_; });
+        if (failed_) {
+            errno = EIO;
+            return false;
+        }
+        return checkpoint_locked();
+    }
+
+    struct Stats {
+        std::uint64_t commits = 0;
+        std::uint64_t syncs = 0;
+        std::uint64_t checkpoints = 0;
+        std::uint64_t failed_checkpoints = 0;  // automatic ones, after a commit
+    };
+    Stats stats() {
+        std::lock_guard<std::mutex> lock(m_);
+        return stats_;
+    }
+
+private:
+    enum EntryType : std::uint16_t { Append = 1, Update = 2 };
+
+    struct LogHeader {
+        char magic[8] = {'R', 'E', 'C', 'W', 'A', 'L', '\r', '\n'};
+        std::uint32_t version = 1;
+        std::uint32_t epoch = 1;
+        std::uint64_t data_records = 0;  // records in the data file at the checkpoint
+        std::uint32_t crc = 0;           // of the bytes above
+        std::uint32_t reserved = 0;
+    };
+    struct Entry {
+        std::uint32_t crc;     // of the bytes after this field
+        std::uint32_t epoch;
+        std::uint16_t type;
+        std::uint16_t reserved[3];
+        std::uint64_t index;
+        Record record;
+        std::uint32_t tail;    // keeps the size a multiple of 8
+    };
+    static_assert(sizeof(Entry) == 56, "log entries are 56 bytes");
+    static_assert(std::is_trivially_copyable<Entry>::value, "entries are written with pwrite");
+
+    // The header sits alone in the first 512-byte sector, so its rewrite
+    // at checkpoint is atomic on disks with 512-byte or larger sectors.
+    static constexpr off_t log_header_bytes = 512;
+    // The log grows in steps of this many bytes: fdatasync() then has no
+    // file size change to write out for most batches.
+    static constexpr off_t log_grow_bytes = off_t(8) << 20;
+
+    int data_fd_ = -1;
+    int log_fd_ = -1;
+    std::size_t checkpoint_bytes_;
+    std::uint32_t epoch_ = 1;
+    std::uint64_t size_ = 0;            // including queued appends
+    std::uint64_t committed_size_ = 0;  // durable appends only
+    off_t log_end_ = log_header_bytes;  // where the next batch goes
+    off_t log_allocated_ = 0;
+
+    std::mutex m_;
+    std::condition_variable cv_;
+    std::vector<Entry> pending_;                // queued, not yet written
+    std::uint64_t queued_seq_ = 0;              // commits queued so far
+    std::uint64_t durable_seq_ = 0;             // commits on disk
+    bool flushing_ = false;                     // a leader is writing a batch
+    bool failed_ = false;
+    std::map<std::uint64_t, Record> dirty_;     // durable in the log, not yet checkpointed
+    Stats stats_;
+
+    static std::uint32_t entry_crc(const Entry& e) {
+        return crc32c(reinterpret_cast<const char*>(&e) + sizeof(e.crc), sizeof(e) - sizeof(e.crc));
+    }
+    static std::uint32_t header_crc(const LogHeader& h) {
+        return crc32c(&h, offsetof(LogHeader, crc));
+    }
+
+    bool fail_open() {
+        int err = errno;
+        if (data_fd_ >= 0) ::close(data_fd_);
+        if (log_fd_ >= 0) ::close(log_fd_);
+        data_fd_ = log_fd_ = -1;
+        dirty_.clear();
+        errno = err;
+        return false;
+    }
+
+    bool commit(Entry& e) {
+        std::unique_lock<std::mutex> lock(m_);
+        if (failed_ || log_fd_ < 0) {
+            errno = EIO;
+            return false;
+        }
+        if (e.type == Append) {
+            e.index = size_;
+        } else if (e.index >= size_) {
+            errno = ERANGE;
+            return false;
+        }
+        size_ = std::max(size_, e.index + 1);
+        e.epoch = epoch_;
+        e.crc = entry_crc(e);
+        pending_.push_back(e);
+        const std::uint64_t seq = ++queued_seq_;
+        ++stats_.commits;
+
+        while (durable_seq_ < seq) {
+            if (failed_) {
+                errno = EIO;
+                return false;
+            }
+            if (flushing_) {
+                cv_.wait(lock);
+                continue;
+            }
+            // Become the leader: write out everything queued so far.
+            flushing_ = true;
+            std::vector<Entry> batch;
+            batch.swap(pending_);
+            const std::uint64_t batch_seq = queued_seq_;
+            const off_t at = log_end_;
+            lock.unlock();
+            bool ok = write_batch(batch, at);
+            lock.lock();
+            flushing_ = false;
+            if (ok) {
+                log_end_ = at + static_cast<off_t>(batch.size() * sizeof(Entry));
+                durable_seq_ = batch_seq;
+                // Durable now: make the batch visible to readers, in order.
+                for (const Entry& b : batch) {
+                    dirty_[b.index] = b.record;
+                    committed_size_ = std::max(committed_size_, b.index + 1);
+                }
+                ++stats_.syncs;
+            } else {
+                failed_ = true;
+            }
+            // The batch is acknowledged whatever the checkpoint does;
+            // a failed one only stops later commits.
+            if (ok && static_cast<std::size_t>(log_end_) >= checkpoint_bytes_ && !checkpoint_locked())
+                ++stats_.failed_checkpoints;
+            cv_.notify_all();
+            if (!ok) return false;
+        }
+        return true;
+    }
+
+    // Runs without the lock: only the leader touches the log tail.
+    bool write_batch(const std::vector<Entry>& batch, off_t at) {
+        const std::size_t bytes = batch.size() * sizeof(Entry);
+        if (at + static_cast<off_t>(bytes) > log_allocated_) {
+            off_t want = std::max(log_allocated_ + log_grow_bytes, at + static_cast<off_t>(bytes));
+            if (::ftruncate(log_fd_, want) != 0) return false;
+            log_allocated_ = want;
+        }
+        const char* p = reinterpret_cast<const char*>(batch.data());
+        std::size_t done = 0;
+        while (done < bytes) {
+            ssize_t w = ::pwrite(log_fd_, p + done, bytes - done, at + static_cast<off_t>(done));
+            if (w < 0 && errno == EINTR) continue;
+            if (w <= 0) return false;
+            done += static_cast<std::size_t>(w);
+        }
+        return ::fdatasync(log_fd_) == 0;
+    }
+
+    // Caller holds m_ and no batch is in flight. On failure the header may
+    // or may not have reached the disk, so the log epoch is unknown: the
+    // object is marked failed and the next open() sorts it out.
+    bool checkpoint_locked() {
+        if (!checkpoint_files()) {
+            failed_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    bool checkpoint_files() {
+        for (const auto& kv : dirty_) {
+            if (::pwrite(data_fd_, &kv.second, sizeof(Record),
+                         static_cast<off_t>(kv.first * sizeof(Record))) != static_cast<ssize_t>(sizeof(Record)))
+                return false;
+        }
+        if (::fdatasync(data_fd_) != 0) return false;
+
+        // The data file is durable: a new epoch retires every logged entry.
+        LogHeader h;
+        h.epoch = epoch_ + 1;
+        h.data_records = committed_size_;
+        h.crc = header_crc(h);
+        if (::pwrite(log_fd_, &h, sizeof(h), 0) != static_cast<ssize_t>(sizeof(h)) ||
+            ::fdatasync(log_fd_) != 0)
+            return false;
+        epoch_ = h.epoch;
+        dirty_.clear();
+        // Commits still queued are not in the data file yet; they go to the
+        // log of the new epoch with the next batch.
+        for (Entry& e : pending_) {
+            e.epoch = epoch_;
+            e.crc = entry_crc(e);
+        }
+        log_end_ = log_header_bytes;
+        struct stat st;
+        log_allocated_ = (::fstat(log_fd_, &st) == 0) ? st.st_size : 0;
+        ++stats_.checkpoints;
+        return true;
+    }
+};
+
+#endif // RECORD_WAL_HPP
@@ -0,0 +1,185 @@
+// field_serializer.cpp
+// Complete C++17 tutorial and demo: a field-list serializer built from type
+// traits (see field_serializer.hpp)
+// Compile: g++ -std=c++17 -Wall -Wextra -O2 field_serializer.cpp -o field_serializer
+// Run: ./field_serializer
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include "field_serializer.hpp"
+#include "../11_file_os_interaction/record.hpp"
+
+/*
+serialization.cpp writes a Record with
+    out.write(reinterpret_cast<const char*>(&r), sizeof(Record));
+which copies the memory image, padding included: Record has 26 bytes of
+fields and 2 bytes of tail padding, so every record carries 2 bytes of
+whatever was in memory. A struct such as Sample below is worse: 11 bytes of
+data in 24 bytes of memory.
+
+field_serializer.hpp lets each struct list its fields once:
+    SERIAL_FIELDS(Record, &Record::name, &Record::id, &Record::score, &Record::age);
+and derives everything else with templates:
+
+1. Layout facts as static_asserts (packed size, padding-free or not)
+2. Packed encode / decode of one object or an array, field by field
+3. A single memcpy for arrays of padding-free structs (Tick below)
+4. Nested structs and arrays of structs (Shape below)
+
+Interesting facts & pitfalls:
+- The field list is not checked for completeness: a member you forget is
+  silently not written. For padding-free structs a missing field shows up
+  as packed_size_v < sizeof, so the memcpy path is not taken.
+- The packed format is host byte order; see record_format.hpp for a
+  portable one.
+- Field order in the list is the order on disk. Reordering members of the
+  struct keeps old files readable; reordering the list does not.
+*/
+
+// --------------------------------------------------------------------
+// The types
+// --------------------------------------------------------------------
+
+SERIAL_FIELDS(Record, &Record::name, &Record::id, &Record::score, &Record::age);
+
+struct Tick {  // no holes: written with one memcpy
+    std::uint64_t time;
+    std::uint32_t id;
+    float price;
+};
+SERIAL_FIELDS(Tick, &Tick::time, &Tick::id, &Tick::price);
+
+struct Sample {  // 1 + 7 padding + 8 + 2 + 6 padding
+    std::uint8_t kind;
+    double value;
+    std::uint16_t channel;
+};
+SERIAL_FIELDS(Sample, &Sample::kind, &Sample::value, &Sample::channel);
+
+enum class Color : std::uint8_t { Red, Green, Blue };
+
+struct Point {
+    float x, y;
+};
+SERIAL_FIELDS(Point, &Point::x, &Point::y);
+
+struct Shape {  // nested struct array and an enum
+    Color color;
+    Point corners[3];
+    std::uint32_t id;
+};
+SERIAL_FIELDS(Shape, &Shape::color, &Shape::corners, &Shape::id);
+
+static_assert(serial::packed_size_v<Record> == 26 && sizeof(Record) == 28);
+static_assert(!serial::is_padding_free_v<Record>);
+static_assert(serial::packed_size_v<Tick> == sizeof(Tick) && serial::is_padding_free_v<Tick>);
+static_assert(serial::packed_size_v<Sample> == 11 && sizeof(Sample) == 24);
+static_assert(serial::packed_size_v<Shape> == 1 + 3 * 8 + 4);
+static_assert(serial::is_padding_free_v<Point> && serial::is_padding_free_v<Point[3]>);
+
+// With either declaration, the first encode() stops at a static_assert:
+// struct Bad { const char* text; };  SERIAL_FIELDS(Bad, &Bad::text);
+// struct Twice { float x, y; };      SERIAL_FIELDS(Twice, &Twice::x, &Twice::x, &Twice::y);
+
+using Clock = std::chrono::steady_clock;
+
+template <class F>
+double ms(F f) {
+    auto t0 = Clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+bool same(const Record& a, const Record& b) {
+    return std::memcmp(a.name, b.name, 16) == 0 && a.id == b.id && a.score == b.score && a.age == b.age;
+}
+
+int main() {
+    // --------------------------------------------------------------------
+    // 1. Layout
+    // --------------------------------------------------------------------
+    std::cout << "=== Step 1: Layout (checked at compile time) ===\n";
+    auto show = [](const char* name, std::size_t memory, std::size_t packed, bool padding_free) {
+        std::printf("%-7s sizeof %2zu  packed %2zu  %s\n", name, memory, packed,
+                    padding_free ? "padding-free: memcpy" : "field by field");
+    };
+    show("Record", sizeof(Record), serial::packed_size_v<Record>, serial::is_padding_free_v<Record>);
+    show("Tick", sizeof(Tick), serial::packed_size_v<Tick>, serial::is_padding_free_v<Tick>);
+    show("Sample", sizeof(Sample), serial::packed_size_v<Sample>, serial::is_padding_free_v<Sample>);
+    show("Shape", sizeof(Shape), serial::packed_size_v<Shape>, serial::is_padding_free_v<Shape>);
+    std::cout << "\n";
+
+    // --------------------------------------------------------------------
+    // 2. Round trip through a file
+    // --------------------------------------------------------------------
+    std::cout << "=== Step 2: Records and shapes through records_packed.bin ===\n";
+    std::vector<Record> recs = {
+        {"Alice", 1, 95.5f, 21}, {"Bob", 2, 87.0f, 19}, {"Charlie", 3, 92.3f, 22}, {"Diana", 4, 78.9f, 20}};
+    std::vector<Shape> shapes = {{Color::Red, {{0, 0}, {1, 0}, {0, 1}}, 7},
+                                 {Color::Blue, {{2, 2}, {3, 5}, {-1, 4}}, 8}};
+    {
+        std::ofstream out("records_packed.bin", std::ios::binary | std::ios::trunc);
+        if (!serial::write(out, recs.data(), recs.size()) || !serial::write(out, shapes.data(), shapes.size())) {
+            std::cerr << "Error: Cannot write records_packed.bin\n";
+            return 1;
+        }
+    }
+    std::vector<Record> recs_back(recs.size());
+    std::vector<Shape> shapes_back(shapes.size());
+    std::ifstream in("records_packed.bin", std::ios::binary);
+    in.seekg(0, std::ios::end);
+    std::cout << "file: " << in.tellg() << " bytes (" << recs.size() << " x " << serial::packed_size_v<Record>
+              << " + " << shapes.size() << " x " << serial::packed_size_v<Shape> << ")\n";
+    in.seekg(0);
+    bool ok = serial::read(in, recs_back.data(), recs_back.size()) == recs.size() &&
+              serial::read(in, shapes_back.data(), shapes_back.size()) == shapes.size();
+    for (std::size_t i = 0; ok && i < recs.size(); ++i) {
+        ok = same(recs[i], recs_back[i]);
+        print_record(recs_back[i], i);
+    }
+    for (std::size_t i = 0; ok && i < shapes.size(); ++i)
+        ok = shapes[i].color == shapes_back[i].color && shapes[i].id == shapes_back[i].id &&
+             shapes[i].corners[2].y == shapes_back[i].corners[2].y;
+    std::cout << (ok ? "round trip is exact\n\n" : "ROUND TRIP DIFFERS!\n\n");
+    in.close();
+    std::remove("records_packed.bin");
+
+    // --------------------------------------------------------------------
+    // 3. Arrays: memcpy vs field by field
+    // --------------------------------------------------------------------
+    std::cout << "=== Step 3: Encoding 10000000 objects ===\n";
+    const std::size_t n = 10000000;
+    std::vector<Tick> ticks(n);
+    std::vector<Record> many(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        ticks[i] = Tick{i * 1000, static_cast<std::uint32_t>(i % 500), static_cast<float>(i % 977)};
+        std::snprintf(many[i].name, sizeof(many[i].name), "user%u", static_cast<unsigned>(i % 1000));
+        many[i].id = static_cast<std::uint32_t>(i);
+        many[i].score = static_cast<float>(i % 100);
+        many[i].age = static_cast<std::uint16_t>(i % 90);
+    }
+    std::vector<char> buf(n * sizeof(Record));
+    double tick_array = ms([&] { serial::encode_array(ticks.data(), n, buf.data()); });
+    double tick_fields = ms([&] {
+        char* out = buf.data();
+        for (const Tick& t : ticks) out = serial::encode(t, out);
+    });
+    double rec_fields = ms([&] { serial::encode_array(many.data(), n, buf.data()); });
+    std::vector<Record> many_back(n);
+    double rec_decode = ms([&] { serial::decode_array(many_back.data(), n, buf.data()); });
+    std::cout << "Tick, encode_array (memcpy):    " << tick_array << " ms\n"
+              << "Tick, encode per object:        " << tick_fields << " ms\n"
+              << "Record, encode_array (fields):  " << rec_fields << " ms, "
+              << n * (sizeof(Record) - serial::packed_size_v<Record>) / 1000000 << " MB of padding saved\n"
+              << "Record, decode_array (fields):  " << rec_decode << " ms\n";
+    bool equal = true;
+    for (std::size_t i = 0; equal && i < n; i += 9973) equal = same(many[i], many_back[i]);
+    std::cout << (equal ? "arrays round trip\n" : "ARRAYS DIFFER!\n");
+    return (ok && equal) ? 0 : 1;
+}
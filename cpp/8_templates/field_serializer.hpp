@@ -0,0 +1,374 @@
+// field_serializer.hpp
+// Compile-time "reflection" for plain structs: declare the fields once, get
+// packed binary encode / decode for single objects and arrays.
+//
+//   struct Tick { std::uint64_t time; std::uint32_t id; float price; };
+//   SERIAL_FIELDS(Tick, &Tick::time, &Tick::id, &Tick::price);
+//
+//   std::vector<char> buf(n * serial::packed_size_v<Tick>);
+//   serial::encode_array(ticks.data(), n, buf.data());
+//   serial::write(out_stream, ticks.data(), n);
+//
+// The field list is a tuple of member pointers in serial::fields<T>::list.
+// The traits below (same pattern as custom_trait.cpp and the detection
+// idiom of sfinae_2.cpp) walk it at compile time to:
+// - reject fields that cannot be written as bytes (pointers, std::string,
+//   classes without a field list) with a static_assert naming the problem
+// - compute packed_size_v<T>: the sum of the field sizes, no padding
+// - decide is_padding_free_v<T>: trivially copyable and sizeof(T) equals
+//   the packed size, so the struct has no holes
+//
+// The encoding is the fields in list order, each in host byte order, with
+// no padding. For a padding-free struct whose fields are listed in
+// declaration order that is exactly its memory image, so arrays of it are
+// copied with one memcpy. The order is checked once at run time (member
+// offsets are not constant expressions in C++17), on a value-initialized T.
+//
+// Supported field types: arithmetic types, enums, C arrays and std::array
+// of supported types, and structs with their own SERIAL_FIELDS.
+//
+// A field may be listed only once (checked at compile time). A partial list
+// is allowed: unlisted members are not encoded, decode() leaves them as they
+// were, and such a struct is never padding-free, so it never takes the
+// memcpy path.
+
+#ifndef FIELD_SERIALIZER_HPP
+#define FIELD_SERIALIZER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace serial {
+
+// Specialize (or use SERIAL_FIELDS) with
+//   static constexpr auto list = std::make_tuple(&T::a, &T::b, ...);
+template <typename T>
+struct fields;
+
+} // namespace serial
+
+#define SERIAL_FIELDS(Type, ...)                                       \
+    template <>                                                        \
+    struct serial::fields<Type> {                                      \
+        static constexpr auto list = std::make_tuple(__VA_ARGS__);     \
+    }
+
+// ===============================================================
+// Traits
+// ===============================================================
+
+namespace trait {
+
+template <typename>
+inline constexpr bool dependent_false_v = false;
+
+// Detection idiom: does serial::fields<T>::list exist?
+template <typename T, typename = void>
+struct has_fields : std::false_type {};
+
+template <typename T>
+struct has_fields<T, std::void_t<decltype(serial::fields<T>::list)>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool has_fields_v = has_fields<T>::value;
+
+// M C::*  ->  C and M
+template <typename P>
+struct member_pointer_traits;
+
+template <typename C, typename M>
+struct member_pointer_traits<M C::*> {
+    using class_type = C;
+    using member_type = M;
+};
+
+template <typename T>
+using field_list_t = std::remove_cv_t<decltype(serial::fields<T>::list)>;
+
+// Member pointers of different types never name the same member.
+template <typename A, typename B>
+constexpr bool same_member(A a, B b) {
+    if constexpr (std::is_same_v<A, B>)
+        return a == b;
+    else
+        return false;
+}
+
+template <std::size_t I, typename Tuple, std::size_t... J>
+constexpr bool differs_from_later(const Tuple& t, std::index_sequence<J...>) {
+    return ((J <= I || !same_member(std::get<I>(t), std::get<J>(t))) && ...);
+}
+
+template <typename Tuple, std::size_t... I>
+constexpr bool members_distinct(const Tuple& t, std::index_sequence<I...> all) {
+    return (true && ... && differs_from_later<I>(t, all));
+}
+
+// No member pointer appears twice in the field list of T.
+template <typename T>
+inline constexpr bool fields_distinct_v =
+    members_distinct(serial::fields<T>::list, std::make_index_sequence<std::tuple_size_v<field_list_t<T>>>());
+
+// Element type of C arrays and std::array
+template <typename T>
+struct array_traits : std::false_type {};
+
+template <typename E, std::size_t N>
+struct array_traits<E[N]> : std::true_type {
+    using element_type = E;
+    static constexpr std::size_t size = N;
+};
+
+template <typename E, std::size_t N>
+struct array_traits<std::array<E, N>> : std::true_type {
+    using element_type = E;
+    static constexpr std::size_t size = N;
+};
+
+// Primary template: not serializable
+template <typename T, typename = void>
+struct is_serializable_impl : std::false_type {};
+
+template <typename T>
+struct is_serializable;
+
+template <typename T>
+struct is_serializable_impl<T, std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>>
+    : std::true_type {};
+
+template <typename T>
+struct is_serializable_impl<T, std::enable_if_t<array_traits<T>::value>>
+    : is_serializable<typename array_traits<T>::element_type> {};
+
+template <typename Tuple>
+struct fields_serializable;
+
+template <typename... P>
+struct fields_serializable<std::tuple<P...>>
+    : std::conjunction<is_serializable<typename member_pointer_traits<P>::member_type>...> {};
+
+template <typename T>
+struct is_serializable_impl<T, std::enable_if_t<has_fields_v<T>>>
+    : fields_serializable<field_list_t<T>> {};
+
+// Public trait: strips cv-qualifiers first
+template <typename T>
+struct is_serializable : is_serializable_impl<std::remove_cv_t<T>> {};
+
+template <typename T>
+inline constexpr bool is_serializable_v = is_serializable<T>::value;
+
+// Every member pointer of T's list must point into T itself.
+template <typename T, typename Tuple>
+struct fields_belong_to;
+
+template <typename T, typename... P>
+struct fields_belong_to<T, std::tuple<P...>>
+    : std::conjunction<std::is_same<typename member_pointer_traits<P>::class_type, T>...> {};
+
+// Packed size in bytes; only meaningful when is_serializable_v<T>.
+template <typename T>
+constexpr std::size_t packed_size();
+
+template <typename... P>
+constexpr std::size_t fields_packed_size(std::tuple<P...>*) {
+    return (std::size_t(0) + ... +
+            packed_size<std::remove_cv_t<typename member_pointer_traits<P>::member_type>>());
+}
+
+template <typename T>
+constexpr std::size_t packed_size() {
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+        return sizeof(T);
+    else if constexpr (array_traits<T>::value)
+        return array_traits<T>::size * packed_size<typename array_traits<T>::element_type>();
+    else if constexpr (has_fields_v<T>)
+        return fields_packed_size(static_cast<field_list_t<T>*>(nullptr));
+    else
+        return 0;
+}
+
+// No holes: the memory image and the packed encoding have the same size.
+template <typename T>
+struct is_padding_free
+    : std::bool_constant<std::is_trivially_copyable_v<T> && sizeof(T) == packed_size<T>()> {};
+
+template <typename T>
+inline constexpr bool is_padding_free_v = is_padding_free<std::remove_cv_t<T>>::value;
+
+} // namespace trait
+
+// ===============================================================
+// Encoding
+// ===============================================================
+
+namespace serial {
+
+template <typename T>
+inline constexpr std::size_t packed_size_v = trait::packed_size<std::remove_cv_t<T>>();
+
+template <typename T>
+inline constexpr bool is_padding_free_v = trait::is_padding_free_v<T>;
+
+template <typename T>
+constexpr void check_fields() {
+    static_assert(trait::is_serializable_v<T>,
+                  "a field cannot be serialized: use arithmetic, enum or array fields, "
+                  "or declare SERIAL_FIELDS for nested structs (no pointers or std::string)");
+    if constexpr (trait::has_fields_v<T>) {
+        static_assert(trait::fields_belong_to<T, trait::field_list_t<T>>::value,
+                      "SERIAL_FIELDS lists a member pointer of another type");
+        static_assert(trait::fields_distinct_v<T>, "SERIAL_FIELDS lists a field twice");
+    }
+}
+
+// True when the packed encoding of T is its memory image: padding-free and
+// (for structs) fields listed in declaration order, recursively.
+template <typename T>
+bool memory_image_matches() {
+    if constexpr (!is_padding_free_v<T>) {
+        return false;
+    } else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+        return true;
+    } else if constexpr (trait::array_traits<T>::value) {
+        return memory_image_matches<typename trait::array_traits<T>::element_type>();
+    } else if constexpr (!std::is_default_constructible_v<T>) {
+        return false;
+    } else {
+        static const bool matches = [] {
+            const T probe{};
+            const char* base = reinterpret_cast<const char*>(&probe);
+            std::size_t at = 0;
+            bool ok = true;
+            std::apply([&](auto... mp) {
+                ((ok = ok && reinterpret_cast<const char*>(&(probe.*mp)) - base == static_cast<std::ptrdiff_t>(at) &&
+                       memory_image_matches<std::remove_cv_t<std::remove_reference_t<decltype(probe.*mp)>>>(),
+                  at += packed_size_v<std::remove_reference_t<decltype(probe.*mp)>>), ...);
+            }, fields<T>::list);
+            return ok;
+        }();
+        return matches;
+    }
+}
+
+// Writes v to out field by field; returns out + packed_size_v<T>.
+template <typename T>
+char* encode(const T& v, char* out) {
+    check_fields<T>();
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+        std::memcpy(out, &v, sizeof(T));
+        return out + sizeof(T);
+    } else if constexpr (trait::array_traits<T>::value) {
+        using E = typename trait::array_traits<T>::element_type;
+        constexpr std::size_t n = trait::array_traits<T>::size;
+        if constexpr (is_padding_free_v<E>) {
+            if (memory_image_matches<E>()) {
+                std::memcpy(out, &v, n * sizeof(E));
+                return out + n * sizeof(E);
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) out = encode(v[i], out);
+        return out;
+    } else {
+        std::apply([&](auto... mp) { ((out = encode(v.*mp, out)), ...); }, fields<T>::list);
+        return out;
+    }
+}
+
+// Reads v from in; returns in + packed_size_v<T>.
+template <typename T>
+const char* decode(T& v, const char* in) {
+    check_fields<T>();
+    if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>) {
+        std::memcpy(&v, in, sizeof(T));
+        return in + sizeof(T);
+    } else if constexpr (trait::array_traits<T>::value) {
+        using E = typename trait::array_traits<T>::element_type;
+        constexpr std::size_t n = trait::array_traits<T>::size;
+        if constexpr (is_padding_free_v<E>) {
+            if (memory_image_matches<E>()) {
+                std::memcpy(&v, in, n * sizeof(E));
+                return in + n * sizeof(E);
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i) in = decode(v[i], in);
+        return in;
+    } else {
+        std::apply([&](auto... mp) { ((in = decode(v.*mp, in)), ...); }, fields<T>::list);
+        return in;
+    }
+}
+
+// n objects, one memcpy when the encoding is the memory image.
+template <typename T>
+char* encode_array(const T* v, std::size_t n, char* out) {
+    check_fields<T>();
+    if constexpr (is_padding_free_v<T>) {
+        if (memory_image_matches<T>()) {
+            std::memcpy(out, v, n * sizeof(T));
+            return out + n * sizeof(T);
+        }
+    }
+    for (std::size_t i = 0; i < n; ++i) out = encode(v[i], out);
+    return out;
+}
+
+template <typename T>
+const char* decode_array(T* v, std::size_t n, const char* in) {
+    check_fields<T>();
+    if constexpr (is_padding_free_v<T>) {
+        if (memory_image_matches<T>()) {
+            std::memcpy(v, in, n * sizeof(T));
+            return in + n * sizeof(T);
+        }
+    }
+    for (std::size_t i = 0; i < n; ++i) in = decode(v[i], in);
+    return in;
+}
+
+// ===============================================================
+// Streams
+// ===============================================================
+// Encode through a 64 KiB buffer, so a stream sees a few large writes
+// instead of one per field.
+
+constexpr std::size_t stream_chunk = 64 * 1024;
+
+template <typename T>
+bool write(std::ostream& os, const T* v, std::size_t n) {
+    constexpr std::size_t per_chunk = stream_chunk / packed_size_v<T> > 0 ? stream_chunk / packed_size_v<T> : 1;
+    static thread_local char buf[per_chunk * packed_size_v<T>];
+    for (std::size_t i = 0; i < n && os; i += per_chunk) {
+        const std::size_t k = (n - i < per_chunk) ? n - i : per_chunk;
+        char* end = encode_array(v + i, k, buf);
+        os.write(buf, end - buf);
+    }
+    return static_cast<bool>(os);
+}
+
+// Reads up to n objects; returns how many were read completely.
+template <typename T>
+std::size_t read(std::istream& is, T* v, std::size_t n) {
+    constexpr std::size_t per_chunk = stream_chunk / packed_size_v<T> > 0 ? stream_chunk / packed_size_v<T> : 1;
+    static thread_local char buf[per_chunk * packed_size_v<T>];
+    std::size_t done = 0;
+    while (done < n) {
+        const std::size_t k = (n - done < per_chunk) ? n - done : per_chunk;
+        is.read(buf, static_cast<std::streamsize>(k * packed_size_v<T>));
+        const std::size_t got = static_cast<std::size_t>(is.gcount()) / packed_size_v<T>;
+        decode_array(v + done, got, buf);
+        done += got;
+        if (got < k) break;
+    }
+    return done;
+}
+
+} // namespace serial
+
+#endif // FIELD_SERIALIZER_HPP
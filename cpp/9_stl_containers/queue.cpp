@@ -149,7 +149,8 @@ int main() {
           (lexicographical comparison of underlying sequences).
 
         - std::queue is NOT thread-safe by default.
-          Use mutexes or concurrent queues (e.g., from TBB or Boost) in multithreaded code.
+          Use a mutex + condition_variable, or a concurrent queue such as MpmcQueue
+          (../multithreading/mpmc_queue.hpp, lock-free and bounded) in multithreaded code.
 
         Trick: If you need both queue and priority access, consider std::priority_queue.
         If you need random access or frequent middle operations, use the underlying container directly (e.g., std::deque).
@@ -9,40 +9,31 @@ std::pair<V1, V2> SortFunctionOne(V1 Cont1, V2 Cont2, bool (*f)(T, T)){
     // A function to perform sorting based on a comparison relationship
     // given as argument.
     // Containers must be of same size - both subscribable( operand[])
-    // returns a pair of sorted containers.
+    // returns a pair of sorted containers, the arguments are taken by value
+    // so the caller's data is not modified.
     if (Cont1.size() != Cont2.size()){
         printf("Data containers are not of the same size <!>.\n");
         throw "Size mismatch error";
     } else {
 
-    V1 SortedCont1 = Cont1;
-    V2 SortedCont2 = Cont2;
-    auto temp1 = Cont1[0];
-    auto temp2 = Cont2[0];
-    std::pair<V1, V2> result;
-
-    // Sorting loop
-    for (int i=0; i < Cont2.size(); ++i){
-        int piv = i;
-        for (int j = i + 1; j < Cont2.size(); ++j){
-            if ( (*f)(SortedCont2[j], SortedCont2[piv])){
-                piv = j;
-            }
-        }
-        //Sort Container 1======================================================
-        temp1 = SortedCont1[i];
-        SortedCont1[i] = SortedCont1[piv];
-        SortedCont1[piv] = temp1;
-        //======================================================================
-        //Sort Container 2======================================================
-        temp2 = SortedCont2[i];
-        SortedCont2[i] = SortedCont2[piv];
-        SortedCont2[piv] = temp2;
-    }
-    return std::pair<V1, V2>(SortedCont1, SortedCont2);
+    // The permutation that sorts Cont2 is computed once in O(n log n) and
+    // then applied in place to both copies (see SortEngine.hpp).
+    // Equal keys keep their original order.
+    StableSortTogether(Cont2, f, Cont1);
+    return std::pair<V1, V2>(std::move(Cont1), std::move(Cont2));
     }
 }
 
+// function implementation of SortFunctionOne without comparator
+template<class V1, class V2>
+std::pair<V1, V2> SortFunctionOne(V1 Cont1, V2 Cont2){
+    // Same as above with the natural " < " order of Cont2. Without a function
+    // pointer the engine can see the order, so IntV keys take the LSD radix
+    // path (stable too) instead of a comparison sort.
+    StableSortTogether(Cont2, std::less<>(), Cont1);
+    return std::pair<V1, V2>(std::move(Cont1), std::move(Cont2));
+}
+
 // Comparator function
 bool Smaller( int var1, int var2){
     // This is an implementation of " < " operand as example
@@ -54,3 +45,4 @@ bool Smaller( int var1, int var2){
 // Add whatever variante enteries here.
 // for large projects we need to create template file instead of this.
 template std::pair<StrV, IntV> SortFunctionOne<StrV, IntV, int>(StrV Cont1, IntV Cont2, bool (*f)(int, int));
+template std::pair<StrV, IntV> SortFunctionOne<StrV, IntV>(StrV Cont1, IntV Cont2);
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include "SortEngine.hpp"
 // typedef =====================================================================
 using IntV = std::vector<int>;
 using StrV = std::vector<std::string>;
@@ -15,6 +16,9 @@ using StrV = std::vector<std::string>;
 //functions definitions
 template<class V1, class V2, class T>
 std::pair<V1, V2> SortFunctionOne(V1 Cont1, V2 Cont2, bool (*f)(T, T));
+// Ascending order of Cont2; integer keys are radix sorted.
+template<class V1, class V2>
+std::pair<V1, V2> SortFunctionOne(V1 Cont1, V2 Cont2);
 bool Smaller( int var1, int var2);
 
 #endif // ifndef  MYFUNCTIONS_HPP
@@ -0,0 +1,371 @@
+// Template file of the sort engine - Task2App
+// Author: Salah Eddine Ghamri
+#ifndef SORTENGINE_HPP
+#define SORTENGINE_HPP
+
+// include dependecies =========================================================
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <limits>
+#include <type_traits>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "../../multithreading/work_stealing_pool.hpp"
+//==============================================================================
+// Sorting several containers "following the sorting pattern of another one"
+// in two steps:
+//   1. ArgSort computes once, in O(n log n), the permutation that sorts the
+//      key container: Perm[i] is the old index of the element that ends up
+//      at position i.
+//   2. ApplyPermutation moves the elements of any number of containers along
+//      the cycles of that permutation, in place: one element per container
+//      is held aside per cycle, no container is copied.
+// SortTogether / StableSortTogether chain both steps, keys included.
+//
+// Integral keys compared with std::less go through RadixArgSort instead of a
+// comparison sort (LSD radix is stable, so both variants use it).
+// String keys compared with std::less go through StringArgSort (multikey
+// quicksort), which never compares the same prefix twice.
+// ParallelArgSort is a sample sort over all cores for very large inputs.
+//==============================================================================
+
+using Permutation = std::vector<std::size_t>;
+
+// LSD radix argsort of integral keys, ascending and stable.
+// Keys are mapped to unsigned with the sign bit flipped so negative values
+// come first, then sorted by 8-bit (1-2 byte keys) or 11-bit digits. The
+// histograms of every digit are built in one read pass, and a pass whose
+// digit is the same for all keys (one bucket holds n) is skipped.
+template <class Int>
+Permutation RadixArgSort(const std::vector<Int>& keys) {
+    static_assert(std::is_integral<Int>::value, "RadixArgSort needs integral keys");
+    using U = std::make_unsigned_t<Int>;
+    constexpr int Bits = std::numeric_limits<U>::digits;
+    constexpr int DigitBits = (Bits <= 16) ? 8 : 11;
+    constexpr int Passes = (Bits + DigitBits - 1) / DigitBits;
+    constexpr std::size_t Buckets = std::size_t(1) << DigitBits;
+    constexpr U Flip = std::is_signed<Int>::value ? U(U(1) << (Bits - 1)) : U(0);
+
+    const std::size_t n = keys.size();
+    std::vector<U> Key(n), KeyTmp(n);
+    Permutation Perm(n), PermTmp(n);
+    std::vector<std::size_t> Count(Passes * Buckets, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        const U k = static_cast<U>(keys[i]) ^ Flip;
+        Key[i] = k;
+        Perm[i] = i;
+        for (int p = 0; p < Passes; ++p)
+            ++Count[p * Buckets + ((k >> (p * DigitBits)) & (Buckets - 1))];
+    }
+    for (int p = 0; p < Passes; ++p) {
+        std::size_t* C = &Count[p * Buckets];
+        const int Shift = p * DigitBits;
+        if (n == 0 || C[(Key[0] >> Shift) & (Buckets - 1)] == n)
+            continue; // every key has the same digit here
+        std::size_t Sum = 0;
+        for (std::size_t b = 0; b < Buckets; ++b) {
+            const std::size_t c = C[b];
+            C[b] = Sum;
+            Sum += c;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::size_t Dst = C[(Key[i] >> Shift) & (Buckets - 1)]++;
+            KeyTmp[Dst] = Key[i];
+            PermTmp[Dst] = Perm[i];
+        }
+        Key.swap(KeyTmp);
+        Perm.swap(PermTmp);
+    }
+    return Perm;
+}
+
+namespace detail {
+// A key plus a cache of its next 8 characters, so partitioning a level
+// reads the strings once and then only touches this array.
+struct StrItem {
+    const char* Data;
+    std::size_t Size;
+    std::size_t Index;
+    std::uint64_t Word; // chars [d, d+8) big-endian, zero padded
+    std::uint32_t Count; // how many of them exist (8 unless the string ends)
+};
+
+inline void LoadWord(StrItem& s, std::size_t d) {
+    std::uint64_t w = 0;
+    std::size_t c = (s.Size > d) ? std::min<std::size_t>(8, s.Size - d) : 0;
+    for (std::size_t k = 0; k < c; ++k)
+        w |= std::uint64_t(static_cast<unsigned char>(s.Data[d + k])) << (56 - 8 * k);
+    s.Word = w;
+    s.Count = static_cast<std::uint32_t>(c);
+}
+
+// Order of the cached 8 characters; a shorter string sorts first.
+inline int CompareWord(const StrItem& a, const StrItem& b) {
+    if (a.Word != b.Word) return a.Word < b.Word ? -1 : 1;
+    return (a.Count == b.Count) ? 0 : (a.Count < b.Count ? -1 : 1);
+}
+
+// Compares from depth d on; equal strings are ordered by index.
+inline bool SuffixLess(const StrItem& a, const StrItem& b, std::size_t d) {
+    const std::size_t n = std::min(a.Size, b.Size);
+    int c = (n > d) ? std::memcmp(a.Data + d, b.Data + d, n - d) : 0;
+    if (c != 0) return c < 0;
+    if (a.Size != b.Size) return a.Size < b.Size;
+    return a.Index < b.Index;
+}
+
+const std::size_t StringInsertionBelow = 16;
+
+// Bentley-Sedgewick multikey quicksort on items sharing their first d
+// chars, taking 8 chars per level instead of one.
+inline void MultikeyQuicksort(StrItem* a, std::size_t n, std::size_t d, bool Loaded) {
+    while (n >= StringInsertionBelow) {
+        if (!Loaded)
+            for (std::size_t i = 0; i < n; ++i) LoadWord(a[i], d);
+        // Median of three as pivot.
+        StrItem x = a[0], y = a[n / 2], z = a[n - 1];
+        if (CompareWord(y, x) < 0) std::swap(x, y);
+        if (CompareWord(z, y) < 0) y = (CompareWord(z, x) < 0) ? x : z;
+        const StrItem Pivot = y;
+        // Three-way partition: [0, lt) < Pivot, [lt, gt) == Pivot, [gt, n) > Pivot.
+        std::size_t lt = 0, i = 0, gt = n;
+        while (i < gt) {
+            int c = CompareWord(a[i], Pivot);
+            if (c < 0) std::swap(a[lt++], a[i++]);
+            else if (c > 0) std::swap(a[i], a[--gt]);
+            else ++i;
+        }
+        MultikeyQuicksort(a, lt, d, true);
+        MultikeyQuicksort(a + gt, n - gt, d, true);
+        if (Pivot.Count < 8) {
+            // Whole strings are equal: keep them in index order (stable).
+            std::sort(a + lt, a + gt, [](const StrItem& p, const StrItem& q) { return p.Index < q.Index; });
+            return;
+        }
+        a += lt; // continue on the equal part 8 characters deeper
+        n = gt - lt;
+        d += 8;
+        Loaded = false;
+    }
+    for (std::size_t i = 1; i < n; ++i)
+        for (std::size_t j = i; j > 0 && SuffixLess(a[j], a[j - 1], d); --j)
+            std::swap(a[j], a[j - 1]);
+}
+} // namespace detail
+
+// Stable argsort of string keys (std::string, std::string_view, ...).
+template <class Strings>
+Permutation StringArgSort(const Strings& keys) {
+    std::vector<detail::StrItem> Items(keys.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+        std::string_view s(keys[i]);
+        Items[i] = detail::StrItem{s.data(), s.size(), i, 0, 0};
+    }
+    detail::MultikeyQuicksort(Items.data(), Items.size(), 0, false);
+    Permutation Perm(Items.size());
+    for (std::size_t i = 0; i < Items.size(); ++i) Perm[i] = Items[i].Index;
+    return Perm;
+}
+
+namespace detail {
+template <class T, class Compare>
+constexpr bool IsLess = std::is_same<Compare, std::less<>>::value
+                     || std::is_same<Compare, std::less<T>>::value;
+
+// True when keys are a std::vector of strings compared with std::less.
+template <class Keys, class Compare>
+struct UseStringSort : std::false_type {};
+template <class Alloc, class Compare>
+struct UseStringSort<std::vector<std::string, Alloc>, Compare>
+    : std::integral_constant<bool, IsLess<std::string, Compare>> {};
+template <class Alloc, class Compare>
+struct UseStringSort<std::vector<std::string_view, Alloc>, Compare>
+    : std::integral_constant<bool, IsLess<std::string_view, Compare>> {};
+} // namespace detail
+
+namespace detail {
+// True when keys are a std::vector of integers compared with std::less.
+template <class Keys, class Compare, class = void>
+struct UseRadix : std::false_type {};
+template <class Int, class Alloc, class Compare>
+struct UseRadix<std::vector<Int, Alloc>, Compare,
+                std::enable_if_t<std::is_integral<Int>::value && !std::is_same<Int, bool>::value
+                                 && (std::is_same<Compare, std::less<>>::value
+                                     || std::is_same<Compare, std::less<Int>>::value)>>
+    : std::true_type {};
+} // namespace detail
+
+template <class Keys, class Compare = std::less<>>
+Permutation ArgSort(const Keys& keys, Compare comp = Compare()) {
+    if constexpr (detail::UseRadix<Keys, Compare>::value)
+        return RadixArgSort(keys);
+    if constexpr (detail::UseStringSort<Keys, Compare>::value)
+        return StringArgSort(keys);
+    Permutation Perm(keys.size());
+    std::iota(Perm.begin(), Perm.end(), std::size_t(0));
+    std::sort(Perm.begin(), Perm.end(),
+              [&](std::size_t a, std::size_t b) { return comp(keys[a], keys[b]); });
+    return Perm;
+}
+
+// Equal keys keep their original order.
+template <class Keys, class Compare = std::less<>>
+Permutation StableArgSort(const Keys& keys, Compare comp = Compare()) {
+    if constexpr (detail::UseRadix<Keys, Compare>::value)
+        return RadixArgSort(keys);
+    if constexpr (detail::UseStringSort<Keys, Compare>::value)
+        return StringArgSort(keys);
+    Permutation Perm(keys.size());
+    std::iota(Perm.begin(), Perm.end(), std::size_t(0));
+    std::stable_sort(Perm.begin(), Perm.end(),
+                     [&](std::size_t a, std::size_t b) { return comp(keys[a], keys[b]); });
+    return Perm;
+}
+
+namespace detail {
+template <class Held, class... Conts, std::size_t... I>
+void PutBack(Held& held, std::size_t j, std::index_sequence<I...>, Conts&... conts) {
+    ((conts[j] = std::move(std::get<I>(held))), ...);
+}
+} // namespace detail
+
+// Reorders every container so that c[i] becomes the old c[Perm[i]].
+// Perm is consumed (each visited entry is reset to its own index), so pass
+// std::move(Perm) when it is not needed afterwards.
+template <class... Conts>
+void ApplyPermutation(Permutation Perm, Conts&... conts) {
+    static_assert(sizeof...(Conts) > 0, "Nothing to permute");
+    const std::size_t n = Perm.size();
+    if (((conts.size() != n) || ...)) {
+        printf("Data containers are not of the same size <!>.\n");
+        throw "Size mismatch error";
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (Perm[i] == i) continue; // fixed point or cycle already done
+        std::tuple<typename Conts::value_type...> Held(std::move(conts[i])...);
+        std::size_t j = i;
+        while (Perm[j] != i) {
+            const std::size_t k = Perm[j];
+            ((conts[j] = std::move(conts[k])), ...);
+            Perm[j] = j;
+            j = k;
+        }
+        detail::PutBack(Held, j, std::index_sequence_for<Conts...>(), conts...);
+        Perm[j] = j;
+    }
+}
+
+// Sorts keys with comp and applies the same moves to the companions.
+template <class Keys, class Compare, class... Companions>
+void SortTogether(Keys& keys, Compare comp, Companions&... companions) {
+    ApplyPermutation(ArgSort(keys, comp), keys, companions...);
+}
+
+template <class Keys, class Compare, class... Companions>
+void StableSortTogether(Keys& keys, Compare comp, Companions&... companions) {
+    ApplyPermutation(StableArgSort(keys, comp), keys, companions...);
+}
+
+// Below this many keys ParallelArgSort just calls the serial argsorts.
+const std::size_t ParallelSortThreshold = std::size_t(1) << 16;
+
+// Parallel sample sort of the key indices:
+//   1. SampleRate * Threads evenly spaced keys are sorted and Threads - 1 of
+//      them are kept as splitters;
+//   2. each thread buckets the indices of its slice of keys into per-thread
+//      buffers (a key goes right of every splitter it is not less than, so
+//      equal keys always share a bucket);
+//   3. each thread gathers one bucket, pieces in slice order, and sorts it.
+//      Integral and string keys compared with std::less go through the
+//      radix and multikey sorts of ArgSort, on a copy of the bucket's keys
+//      (string keys as string_views); other keys are sorted by comparison.
+// The buckets are laid out in order in the result, so no merge is needed.
+// Every bucket starts in index order and the radix and string sorts are
+// stable, so with Stable (or with those keys) the result equals
+// StableArgSort for any thread count. bench_parallel_sort.cpp checks this. Threads is the
+// number of slices and buckets, run as tasks on WorkStealingPool::shared()
+// (0: one per worker).
+template <class Keys, class Compare = std::less<>>
+Permutation ParallelArgSort(const Keys& keys, Compare comp = Compare(),
+                            bool Stable = false, unsigned Threads = 0) {
+    const std::size_t n = keys.size();
+    WorkStealingPool& Pool = WorkStealingPool::shared();
+    if (Threads == 0) Threads = Pool.size();
+    if (n < ParallelSortThreshold || Threads == 1)
+        return Stable ? StableArgSort(keys, comp) : ArgSort(keys, comp);
+
+    const std::size_t SampleRate = 32;
+    std::vector<typename Keys::value_type> Sample;
+    const std::size_t Samples = SampleRate * Threads;
+    for (std::size_t s = 0; s < Samples; ++s)
+        Sample.push_back(keys[s * n / Samples]);
+    std::sort(Sample.begin(), Sample.end(), comp);
+    std::vector<typename Keys::value_type> Splitters;
+    for (unsigned b = 1; b < Threads; ++b)
+        Splitters.push_back(Sample[b * SampleRate]);
+
+    auto Run = [&Pool, Threads](auto Work) {
+        Pool.parallel_for(0, Threads, [&](std::size_t t) { Work(static_cast<unsigned>(t)); }, 1);
+    };
+
+    // Local[t][b]: indices of slice t that fall in bucket b, in index order.
+    std::vector<std::vector<Permutation>> Local(Threads, std::vector<Permutation>(Threads));
+    Run([&](unsigned t) {
+        const std::size_t Begin = n * t / Threads, End = n * (t + 1) / Threads;
+        for (std::vector<std::size_t>& B : Local[t]) B.reserve((End - Begin) / Threads * 5 / 4);
+        for (std::size_t i = Begin; i < End; ++i) {
+            const std::size_t b = std::upper_bound(Splitters.begin(), Splitters.end(), keys[i], comp)
+                                - Splitters.begin();
+            Local[t][b].push_back(i);
+        }
+    });
+
+    std::vector<std::size_t> Offset(Threads + 1, 0);
+    for (unsigned b = 0; b < Threads; ++b) {
+        Offset[b + 1] = Offset[b];
+        for (unsigned t = 0; t < Threads; ++t) Offset[b + 1] += Local[t][b].size();
+    }
+    Permutation Perm(n);
+    Run([&](unsigned b) {
+        auto Out = Perm.begin() + Offset[b];
+        for (unsigned t = 0; t < Threads; ++t) {
+            Out = std::copy(Local[t][b].begin(), Local[t][b].end(), Out);
+            Permutation().swap(Local[t][b]);
+        }
+        const auto First = Perm.begin() + Offset[b], Last = Perm.begin() + Offset[b + 1];
+        if constexpr (detail::UseRadix<Keys, Compare>::value
+                      || detail::UseStringSort<Keys, Compare>::value) {
+            using Part = std::conditional_t<detail::UseRadix<Keys, Compare>::value,
+                                            typename Keys::value_type, std::string_view>;
+            std::vector<Part> BucketKeys;
+            BucketKeys.reserve(Last - First);
+            for (auto It = First; It != Last; ++It) BucketKeys.push_back(Part(keys[*It]));
+            const Permutation Ids(First, Last);
+            const Permutation Order = ArgSort(BucketKeys);
+            for (std::size_t k = 0; k < Order.size(); ++k) First[k] = Ids[Order[k]];
+        } else {
+            auto Less = [&](std::size_t x, std::size_t y) { return comp(keys[x], keys[y]); };
+            if (Stable)
+                std::stable_sort(First, Last, Less);
+            else
+                std::sort(First, Last, Less);
+        }
+    });
+    return Perm;
+}
+
+// ParallelArgSort followed by the in-place permutation of every container.
+template <class Keys, class Compare, class... Companions>
+void ParallelSortTogether(Keys& keys, Compare comp, bool Stable, Companions&... companions) {
+    ApplyPermutation(ParallelArgSort(keys, comp, Stable), keys, companions...);
+}
+
+#endif // ifndef SORTENGINE_HPP
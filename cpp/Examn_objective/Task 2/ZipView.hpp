@@ -0,0 +1,177 @@
+// Template file of the zip view - Task2App
+// Author: Salah Eddine Ghamri
+#ifndef ZIPVIEW_HPP
+#define ZIPVIEW_HPP
+
+// include dependecies =========================================================
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <iterator>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+//==============================================================================
+// The "python zip" approach from test.cpp, without building a vector of
+// pairs: Zip(keys, other...) is a view whose iterator dereferences to a
+// proxy (ZipRef) referring to the i-th element of every container. Moving,
+// assigning or swapping a proxy moves, assigns or swaps all of them, so
+// std::sort and std::stable_sort reorder the containers together, in place.
+//
+//     ZipSort(Keys, std::less<>(), Names, Scores);   // sorted by Keys
+//
+// The comparator is a plain functor on keys: it is a template argument of
+// std::sort, so it is inlined, unlike the bool (*f)(T, T) of SortFunctionOne.
+// Everything is in this header, nothing needs an explicit instantiation.
+// Any random-access container works (std::vector, std::array, std::deque,
+// std::string...): the view keeps each container's begin() iterator and
+// indexes through it. Containers of proxies such as std::vector<bool> do not.
+// bench_zip.cpp compares ZipStableSort with SortFunctionOne.
+//==============================================================================
+
+template <class... Ts>
+class ZipRef {
+    std::tuple<Ts&...> Refs;
+
+    template <class Tuple, std::size_t... I>
+    void AssignFrom(Tuple&& t, std::index_sequence<I...>) {
+        ((std::get<I>(Refs) = std::get<I>(std::forward<Tuple>(t))), ...);
+    }
+    template <std::size_t... I>
+    void MoveFrom(ZipRef& o, std::index_sequence<I...>) {
+        ((std::get<I>(Refs) = std::move(std::get<I>(o.Refs))), ...);
+    }
+    template <std::size_t... I>
+    void SwapWith(ZipRef& o, std::index_sequence<I...>) {
+        using std::swap;
+        (swap(std::get<I>(Refs), std::get<I>(o.Refs)), ...);
+    }
+    template <std::size_t... I>
+    std::tuple<Ts...> Take(std::index_sequence<I...>) {
+        return std::tuple<Ts...>(std::move(std::get<I>(Refs))...);
+    }
+
+ public:
+    using value_type = std::tuple<Ts...>;
+    using Seq = std::index_sequence_for<Ts...>;
+
+    explicit ZipRef(Ts&... elements) : Refs(elements...) {}
+    ZipRef(const ZipRef&) = default;
+
+    // Assignments write through to the referenced elements.
+    ZipRef& operator=(const ZipRef& o) { AssignFrom(std::tuple<const Ts&...>(o.Refs), Seq()); return *this; }
+    ZipRef& operator=(ZipRef&& o) {
+        if (&std::get<0>(Refs) != &std::get<0>(o.Refs)) MoveFrom(o, Seq());
+        return *this;
+    }
+    ZipRef& operator=(value_type&& v) { AssignFrom(std::move(v), Seq()); return *this; }
+    ZipRef& operator=(const value_type& v) { AssignFrom(v, Seq()); return *this; }
+
+    // "value_type tmp = std::move(*it)" in the sort algorithms lands here.
+    operator value_type() && { return Take(Seq()); }
+    operator value_type() const& { return value_type(Refs); }
+
+    const auto& Key() const { return std::get<0>(Refs); }
+    template <std::size_t I> auto& get() const { return std::get<I>(Refs); }
+
+    friend void swap(ZipRef a, ZipRef b) { a.SwapWith(b, Seq()); }
+};
+
+// Key of either a proxy or a value held aside by the sort algorithm.
+template <class... Ts>
+const auto& ZipKey(const ZipRef<Ts...>& r) { return r.Key(); }
+template <class... Ts>
+const auto& ZipKey(const std::tuple<Ts...>& v) { return std::get<0>(v); }
+
+// Lifts a comparator on keys to a comparator on zipped elements.
+template <class Compare>
+struct ByKey {
+    Compare comp;
+    template <class A, class B>
+    bool operator()(const A& a, const B& b) const { return comp(ZipKey(a), ZipKey(b)); }
+};
+
+// Its are the begin() iterators of the zipped containers.
+template <class... Its>
+class ZipIterator {
+    static_assert((std::is_base_of<std::random_access_iterator_tag,
+                       typename std::iterator_traits<Its>::iterator_category>::value && ...),
+                  "Zip needs random-access containers");
+    std::tuple<Its...> Base;
+    std::ptrdiff_t Pos;
+
+ public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::tuple<typename std::iterator_traits<Its>::value_type...>;
+    using difference_type = std::ptrdiff_t;
+    using reference = ZipRef<typename std::iterator_traits<Its>::value_type...>;
+    using pointer = void;
+
+ private:
+    template <std::size_t... I>
+    reference At(std::ptrdiff_t i, std::index_sequence<I...>) const {
+        return reference(std::get<I>(Base)[i]...);
+    }
+
+ public:
+    ZipIterator() : Pos(0) {}
+    ZipIterator(std::tuple<Its...> base, std::ptrdiff_t pos) : Base(base), Pos(pos) {}
+
+    reference operator*() const { return At(Pos, std::index_sequence_for<Its...>()); }
+    reference operator[](difference_type n) const { return At(Pos + n, std::index_sequence_for<Its...>()); }
+
+    ZipIterator& operator++() { ++Pos; return *this; }
+    ZipIterator& operator--() { --Pos; return *this; }
+    ZipIterator operator++(int) { ZipIterator t = *this; ++Pos; return t; }
+    ZipIterator operator--(int) { ZipIterator t = *this; --Pos; return t; }
+    ZipIterator& operator+=(difference_type n) { Pos += n; return *this; }
+    ZipIterator& operator-=(difference_type n) { Pos -= n; return *this; }
+    friend ZipIterator operator+(ZipIterator it, difference_type n) { return it += n; }
+    friend ZipIterator operator+(difference_type n, ZipIterator it) { return it += n; }
+    friend ZipIterator operator-(ZipIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const ZipIterator& a, const ZipIterator& b) { return a.Pos - b.Pos; }
+
+    friend bool operator==(const ZipIterator& a, const ZipIterator& b) { return a.Pos == b.Pos; }
+    friend bool operator!=(const ZipIterator& a, const ZipIterator& b) { return a.Pos != b.Pos; }
+    friend bool operator<(const ZipIterator& a, const ZipIterator& b) { return a.Pos < b.Pos; }
+    friend bool operator>(const ZipIterator& a, const ZipIterator& b) { return a.Pos > b.Pos; }
+    friend bool operator<=(const ZipIterator& a, const ZipIterator& b) { return a.Pos <= b.Pos; }
+    friend bool operator>=(const ZipIterator& a, const ZipIterator& b) { return a.Pos >= b.Pos; }
+};
+
+template <class... Its>
+class ZipView {
+    std::tuple<Its...> Base;
+    std::size_t Size;
+ public:
+    ZipView(std::tuple<Its...> base, std::size_t size) : Base(base), Size(size) {}
+    ZipIterator<Its...> begin() const { return ZipIterator<Its...>(Base, 0); }
+    ZipIterator<Its...> end() const { return ZipIterator<Its...>(Base, static_cast<std::ptrdiff_t>(Size)); }
+    std::size_t size() const { return Size; }
+};
+
+template <class... Conts>
+ZipView<decltype(std::begin(std::declval<Conts&>()))...> Zip(Conts&... conts) {
+    const std::size_t n = std::get<0>(std::tie(conts...)).size();
+    if (((conts.size() != n) || ...)) {
+        printf("Data containers are not of the same size <!>.\n");
+        throw "Size mismatch error";
+    }
+    return ZipView<decltype(std::begin(conts))...>(std::make_tuple(std::begin(conts)...), n);
+}
+
+// Sorts keys with comp and moves the companions' elements along, in place.
+template <class Keys, class Compare, class... Companions>
+void ZipSort(Keys& keys, Compare comp, Companions&... companions) {
+    auto View = Zip(keys, companions...);
+    std::sort(View.begin(), View.end(), ByKey<Compare>{comp});
+}
+
+template <class Keys, class Compare, class... Companions>
+void ZipStableSort(Keys& keys, Compare comp, Companions&... companions) {
+    auto View = Zip(keys, companions...);
+    std::stable_sort(View.begin(), View.end(), ByKey<Compare>{comp});
+}
+
+#endif // ifndef ZIPVIEW_HPP
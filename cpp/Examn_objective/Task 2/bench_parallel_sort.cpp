@@ -0,0 +1,82 @@
+/*==============================================================================
+# Title           : bench_parallel_sort.cpp of Task2App
+# Description     : Times ParallelArgSort against the serial argsorts on
+#                   duplicate-heavy keys (integers, strings and a function
+#                   pointer comparator), for 1, 2, 4 ... slices, and checks
+#                   that the stable results equal StableArgSort, that the
+#                   unstable ones are sorted, and that small inputs take the
+#                   serial path.
+# Usage           : g++ -std=c++17 -O2 -pthread bench_parallel_sort.cpp
+#                       Myfunctions.cpp -o bench_parallel_sort
+#                   ./bench_parallel_sort [n]
+# C++_version     : C++17
+# ==============================================================================
+*/
+#include "Myfunctions.hpp"
+#include <chrono>
+#include <random>
+#include <thread>
+
+template <class F>
+double Seconds(F f){
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+template <class Keys, class Compare>
+bool IsSortedBy(const Keys& keys, const Permutation& Perm, Compare comp){
+    for (std::size_t i = 1; i < Perm.size(); ++i)
+        if (comp(keys[Perm[i]], keys[Perm[i - 1]])) return false;
+    return Perm.size() == keys.size();
+}
+
+// One line per slice count: speed-up of ParallelArgSort over the serial
+// argsort of the same stability, and whether the result is right.
+template <class Keys, class Compare>
+bool Run(const Keys& keys, Compare comp, const char* Label){
+    Permutation Serial, SerialStable;
+    const double tSerial = Seconds([&] { Serial = ArgSort(keys, comp); });
+    const double tStable = Seconds([&] { SerialStable = StableArgSort(keys, comp); });
+    printf("%s: ArgSort %.3f s, StableArgSort %.3f s\n", Label, tSerial, tStable);
+    bool Ok = IsSortedBy(keys, Serial, comp);
+    const unsigned MaxSlices = std::max(4u, WorkStealingPool::shared().size());
+    for (unsigned Slices = 1; Slices <= MaxSlices; Slices *= 2) {
+        Permutation Fast, FastStable;
+        const double tFast = Seconds([&] { Fast = ParallelArgSort(keys, comp, false, Slices); });
+        const double tFastStable = Seconds([&] { FastStable = ParallelArgSort(keys, comp, true, Slices); });
+        const bool Sorted = IsSortedBy(keys, Fast, comp);
+        const bool Same = (FastStable == SerialStable);
+        printf("  %2u slices: unstable %.3f s (x%.2f) %s | stable %.3f s (x%.2f) %s\n",
+               Slices, tFast, tSerial / tFast, Sorted ? "sorted" : "NOT SORTED",
+               tFastStable, tStable / tFastStable, Same ? "== StableArgSort" : "DIFFERS");
+        Ok = Ok && Sorted && Same;
+    }
+    return Ok;
+}
+
+int main(int args, char** argv){
+    const std::size_t n = (args > 1) ? std::stoul(argv[1]) : 10000000;
+    printf("n=%zu, %u pool workers, %u hardware threads\n", n,
+           WorkStealingPool::shared().size(), std::thread::hardware_concurrency());
+    std::mt19937 Gen(42);
+    std::uniform_int_distribution<int> Dist(0, 1000); // ~n/1000 copies of each key
+    IntV Keys(n);
+    for (int& k : Keys) k = Dist(Gen);
+    StrV Names(n / 10);
+    for (std::string& s : Names) s = "sensor_" + std::to_string(Dist(Gen));
+
+    bool Ok = Run(Keys, std::less<>(), "int keys, radix buckets");
+    Ok = Run(Names, std::less<>(), "string keys, multikey buckets") && Ok;
+    Ok = Run(Keys, Smaller, "int keys, Smaller comparator") && Ok;
+
+    // Below ParallelSortThreshold the serial argsorts run unchanged.
+    IntV Few(Keys.begin(), Keys.begin() + std::min(n, ParallelSortThreshold - 1));
+    const bool Fallback = ParallelArgSort(Few, Smaller, true, 8) == StableArgSort(Few, Smaller)
+                       && ParallelArgSort(Few, Smaller, false, 8) == ArgSort(Few, Smaller);
+    printf("%zu keys (below the threshold): %s\n", Few.size(),
+           Fallback ? "same as the serial argsorts" : "DIFFERS FROM THE SERIAL ARGSORTS");
+    Ok = Ok && Fallback;
+    printf("%s\n", Ok ? "all results correct" : "WRONG RESULTS");
+    return Ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
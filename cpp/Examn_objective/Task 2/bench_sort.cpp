@@ -0,0 +1,49 @@
+/*==============================================================================
+# Title           : bench_sort.cpp of Task2App
+# Description     : Times the permutation step of the sort engine for IntV
+#                   keys: LSD radix against std::sort / std::stable_sort
+#                   argsorts, and checks they agree.
+# Usage           : g++ -std=c++17 -O2 bench_sort.cpp Myfunctions.cpp -o bench_sort
+#                   ./bench_sort [n ...]      e.g. ./bench_sort 1000000 100000000
+# C++_version     : C++17
+# ==============================================================================
+*/
+#include "Myfunctions.hpp"
+#include <chrono>
+#include <random>
+
+template <class F>
+double Seconds(F f){
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void Run(std::size_t n, int Lo, int Hi, const char* Label){
+    std::mt19937 Gen(42);
+    std::uniform_int_distribution<int> Dist(Lo, Hi);
+    IntV Keys(n);
+    for (int& k : Keys) k = Dist(Gen);
+
+    Permutation Radix, Quick, Stable;
+    double tRadix = Seconds([&] { Radix = RadixArgSort(Keys); });
+    double tQuick = Seconds([&] { Quick = ArgSort(Keys, Smaller); });
+    double tStable = Seconds([&] { Stable = StableArgSort(Keys, Smaller); });
+    bool Same = (Radix == Stable);
+    for (std::size_t i = 1; Same && i < n; ++i)
+        Same = Keys[Quick[i - 1]] <= Keys[Quick[i]];
+    printf("%11zu %-10s radix %7.3f s | std::sort %7.3f s (x%.1f) | std::stable_sort %7.3f s (x%.1f) %s\n",
+           n, Label, tRadix, tQuick, tQuick / tRadix, tStable, tStable / tRadix,
+           Same ? "" : "MISMATCH");
+}
+
+int main(int args, char** argv){
+    std::vector<std::size_t> Sizes;
+    for (int a = 1; a < args; ++a) Sizes.push_back(std::stoul(argv[a]));
+    if (Sizes.empty()) Sizes = {1000000, 10000000};
+    for (std::size_t n : Sizes) {
+        Run(n, -2000000000, 2000000000, "full");
+        Run(n, 0, 2000, "0..2000"); // upper digits equal: those passes are skipped
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,64 @@
+/*==============================================================================
+# Title           : bench_zip.cpp of Task2App
+# Description     : Sorts (name, key) pairs by key three ways and checks they
+#                   agree: SortFunctionOne with the Smaller function pointer,
+#                   SortFunctionOne without comparator (radix argsort), and
+#                   ZipStableSort in place with a functor, on vectors
+#                   and on deques.
+# Usage           : g++ -std=c++17 -O2 -pthread bench_zip.cpp Myfunctions.cpp -o bench_zip
+#                   ./bench_zip [n]
+# C++_version     : C++17
+# ==============================================================================
+*/
+#include "Myfunctions.hpp"
+#include "ZipView.hpp"
+#include <chrono>
+#include <deque>
+#include <random>
+
+template <class F>
+double Seconds(F f){
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int args, char** argv){
+    std::size_t n = (args > 1) ? std::stoul(argv[1]) : 1000000;
+    std::mt19937 Gen(42);
+    std::uniform_int_distribution<int> Dist(0, static_cast<int>(n / 4)); // many equal keys
+    StrV Names(n);
+    IntV Keys(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        Keys[i] = Dist(Gen);
+        Names[i] = "name_" + std::to_string(i);
+    }
+
+    // SortFunctionOne copies its arguments and returns sorted copies.
+    std::pair<StrV, IntV> ByPointer, ByRadix;
+    double tPointer = Seconds([&] { ByPointer = SortFunctionOne(Names, Keys, Smaller); });
+    double tRadix = Seconds([&] { ByRadix = SortFunctionOne(Names, Keys); });
+
+    // ZipStableSort reorders the caller's containers: time the copy apart.
+    StrV ZipNames;
+    IntV ZipKeys;
+    double tCopy = Seconds([&] { ZipNames = Names; ZipKeys = Keys; });
+    double tZip = Seconds([&] { ZipStableSort(ZipKeys, std::less<>(), ZipNames); });
+
+    // Same sort on deques: not contiguous, still random-access.
+    std::deque<std::string> DequeNames(Names.begin(), Names.end());
+    std::deque<int> DequeKeys(Keys.begin(), Keys.end());
+    double tDeque = Seconds([&] { ZipStableSort(DequeKeys, std::less<>(), DequeNames); });
+
+    const bool Same = ByPointer == ByRadix && ByRadix.first == ZipNames && ByRadix.second == ZipKeys
+                   && std::equal(DequeNames.begin(), DequeNames.end(), ZipNames.begin())
+                   && std::equal(DequeKeys.begin(), DequeKeys.end(), ZipKeys.begin());
+    printf("n=%zu\n", n);
+    printf("SortFunctionOne(Names, Keys, Smaller): %.3f s (copies included)\n", tPointer);
+    printf("SortFunctionOne(Names, Keys):          %.3f s (copies included, radix)\n", tRadix);
+    printf("ZipStableSort(Keys, less, Names):      %.3f s in place (+%.3f s to copy first)\n",
+           tZip, tCopy);
+    printf("ZipStableSort on std::deque:           %.3f s in place\n", tDeque);
+    printf("%s\n", Same ? "same order, equal keys in input order" : "MISMATCH");
+    return Same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,134 @@
+// Implementation file for CsvCache -Task1App
+// Author: Salah Eddine Ghamri
+//==============================================================================
+#include "CsvCache.hpp"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+//==============================================================================
+
+namespace {
+const char CacheMagic[8] = {'C', 'S', 'V', 'C', 'A', 'C', 'H', 'E'};
+const std::uint32_t CacheVersion = 2; // 2: the delimiter is part of the header
+const std::uint16_t DTypeFloat64 = 1;
+
+// Size and mtime of the source CSV, used to detect a stale cache.
+bool SourceStamp(const std::string& Path, std::uint64_t& Size, std::int64_t& MTimeNs) {
+    struct stat st;
+    if (stat(Path.c_str(), &st) != 0) return false;
+    Size = static_cast<std::uint64_t>(st.st_size);
+    MTimeNs = static_cast<std::int64_t>(st.st_mtim.tv_sec) * 1000000000LL
+            + st.st_mtim.tv_nsec;
+    return true;
+}
+} // namespace
+
+// CsvCache Constructor & Destructor
+CsvCache::CsvCache() : Map(nullptr), MapSize(0) {}
+CsvCache::~CsvCache() { Close(); }
+
+std::string CsvCache::CachePathFor(std::string SourcePath) {
+    return SourcePath + ".cache";
+}
+
+bool CsvCache::IsOpen() const { return Map != nullptr; }
+
+Matrix CsvCache::GetMatrix() const { return View; }
+
+void CsvCache::Close() {
+    if (Map) munmap(Map, MapSize);
+    Map = nullptr;
+    MapSize = 0;
+    View = Matrix();
+}
+
+bool CsvCache::Open(std::string CachePath, std::string SourcePath, char Delimiter) {
+    // Maps the cache read-only and checks it still matches its source CSV.
+    Close();
+    std::uint64_t SrcSize;
+    std::int64_t SrcMTime;
+    if (!SourceStamp(SourcePath, SrcSize, SrcMTime)) return false;
+
+    int fd = open(CachePath.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(CacheHeader))) {
+        close(fd);
+        return false;
+    }
+    std::size_t Size = static_cast<std::size_t>(st.st_size);
+    void* p = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file referenced
+    if (p == MAP_FAILED) return false;
+
+    const CacheHeader* h = static_cast<const CacheHeader*>(p);
+    // Doubles after the header; Cols * ColStride is compared by division so
+    // that a corrupt header cannot overflow its way past the check.
+    const std::uint64_t Slots = (Size - sizeof(CacheHeader)) / sizeof(double);
+    bool Valid = std::memcmp(h->Magic, CacheMagic, sizeof(CacheMagic)) == 0
+              && h->Version == CacheVersion
+              && h->DType == DTypeFloat64
+              && h->Delimiter == Delimiter
+              && h->DataOffset == sizeof(CacheHeader)
+              && h->SourceSize == SrcSize
+              && h->SourceMTimeNs == SrcMTime
+              && h->ColStride >= h->Rows
+              && (h->Cols == 0 || h->ColStride <= Slots / h->Cols);
+    if (!Valid) {
+        munmap(p, Size);
+        return false;
+    }
+    Map = p;
+    MapSize = Size;
+    View.Data = reinterpret_cast<const double*>(static_cast<const char*>(p) + h->DataOffset);
+    View.Rows = h->Rows;
+    View.Cols = h->Cols;
+    View.ColStride = h->ColStride;
+    return true;
+}
+
+bool CsvCache::Write(const std::vector< std::vector<double> >& data,
+                     std::string CachePath, std::string SourcePath, char Delimiter) {
+    // Writes to a temporary file first and renames it, so a reader never maps
+    // a half written cache.
+    CacheHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.Magic, CacheMagic, sizeof(CacheMagic));
+    h.Version = CacheVersion;
+    h.DType = DTypeFloat64;
+    h.Delimiter = Delimiter;
+    h.Rows = data.size();
+    h.Cols = data.empty() ? 0 : data[0].size();
+    h.ColStride = (h.Rows + 7) & ~std::uint64_t(7);
+    h.DataOffset = sizeof(CacheHeader);
+    if (!SourceStamp(SourcePath, h.SourceSize, h.SourceMTimeNs)) return false;
+    for (const std::vector<double>& row : data)
+        if (row.size() != h.Cols) {
+            printf("Ragged rows, cache not written.\n");
+            return false;
+        }
+
+    std::string TmpPath = CachePath + ".tmp";
+    {
+        std::fstream Out(TmpPath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!Out.is_open()) return false;
+        Out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+        std::vector<double> Column(h.ColStride, 0.0);
+        for (std::size_t j = 0; j < h.Cols; ++j) {
+            for (std::size_t i = 0; i < h.Rows; ++i)
+                Column[i] = data[i][j];
+            Out.write(reinterpret_cast<const char*>(Column.data()),
+                      Column.size() * sizeof(double));
+        }
+        if (!Out.good()) {
+            Out.close();
+            std::remove(TmpPath.c_str());
+            return false;
+        }
+    }
+    return std::rename(TmpPath.c_str(), CachePath.c_str()) == 0;
+}
@@ -0,0 +1,56 @@
+// Header file of CsvCache - Task1App
+// Author: Salah Eddine Ghamri
+#ifndef CSVCACHE_HPP
+#define CSVCACHE_HPP
+
+//==============================================================================
+// Included dependencies:
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Matrix.hpp"
+//==============================================================================
+// Binary cache layout (native endianness, the cache never leaves the machine):
+//   [0, 64)        CacheHeader
+//   [64, ...)      Cols columns of ColStride doubles each, column-major.
+// ColStride is Rows rounded up to a multiple of 8, so every column begins on
+// a 64-byte boundary of the file and therefore of the mapping.
+//==============================================================================
+
+struct CacheHeader {
+    char Magic[8];              // "CSVCACHE"
+    std::uint32_t Version;
+    std::uint16_t DType;        // 1 = float64, only type CsvClass stores
+    char Delimiter;             // field separator the CSV was parsed with
+    char Reserved;
+    std::uint64_t Rows;
+    std::uint64_t Cols;
+    std::uint64_t ColStride;    // in elements
+    std::uint64_t SourceSize;   // size of the CSV the cache was built from
+    std::int64_t SourceMTimeNs; // mtime of that CSV, in nanoseconds
+    std::uint64_t DataOffset;   // always 64
+};
+static_assert(sizeof(CacheHeader) == 64, "CacheHeader must fill one cache line");
+
+class CsvCache{
+    void* Map;
+    std::size_t MapSize;
+    Matrix View;
+ public:
+     CsvCache();
+     // Maps CachePath if it is a valid cache of SourcePath (same size/mtime)
+     // parsed with the same Delimiter.
+     bool Open(std::string CachePath, std::string SourcePath, char Delimiter);
+     void Close();
+     bool IsOpen() const;
+     Matrix GetMatrix() const;
+     // Writes a cache of data for SourcePath. Rows must be of equal length.
+     static bool Write(const std::vector< std::vector<double> >& data,
+                       std::string CachePath, std::string SourcePath, char Delimiter);
+     static std::string CachePathFor(std::string SourcePath);
+     CsvCache(const CsvCache&) = delete;
+     CsvCache& operator=(const CsvCache&) = delete;
+     ~CsvCache();
+};
+
+#endif // ifndef CSVCACHE_HPP
@@ -2,65 +2,61 @@
 // Author: Salah Eddine Ghamri
 //==============================================================================
 #include "CsvInOut.hpp"
+#include "CsvParse.hpp"
+#include "../../multithreading/work_stealing_pool.hpp"
+#include <algorithm>
+#include <charconv>
+#include <future>
 //==============================================================================
 
-// CsvClass Constructor & Destructor
-CsvClass::CsvClass() {}
-CsvClass::~CsvClass() {}
-
-void CsvClass::ReadData(std::string InputFilePath, char Delim) {
-    //To Read from a file. It takes the file path and the delimiter character.
-    std::fstream InputFile(InputFilePath, std::ios::in);
-    if (InputFile.is_open()) {
-        printf("Input file is opened.\n");
-
-        std::string line, word;
-        std::vector<double> row;
-        std::stringstream linestream;
-
-        while (getline(InputFile, line)) {
-            linestream.str(line);
-            while (std::getline(linestream, word, Delim)) {
-                row.push_back(std::stod(word));
-            }
-            this->Data.push_back(row); //refering to the class variable
-            row.clear();
-            linestream.clear();
+namespace {
+// Rows formatted per block by WriteData.
+const std::size_t RowsPerBlock = 4096;
+// Longest shortest-form double ("-2.2250738585072014e-308") plus delimiter.
+const std::size_t MaxCharsPerValue = 25;
+
+// Formats rows of block b into Buf, growing it if needed; returns the size.
+std::size_t FormatRows(const Array& data, std::size_t b, char Delimiter,
+                       std::vector<char>& Buf) {
+    const std::size_t Begin = b * RowsPerBlock;
+    const std::size_t End = std::min(Begin + RowsPerBlock, data.size());
+    std::size_t Need = 0;
+    for (std::size_t i = Begin; i < End; ++i)
+        Need += data[i].size() * MaxCharsPerValue;
+    if (Buf.size() < Need)
+        Buf.resize(Need);
+
+    char* p = Buf.data();
+    char* const Last = Buf.data() + Buf.size();
+    for (std::size_t i = Begin; i < End; ++i) {
+        const std::vector<double>& Row = data[i];
+        for (std::size_t j = 0; j < Row.size(); ++j) {
+            p = std::to_chars(p, Last, Row[j]).ptr;
+            *p++ = (j == Row.size() - 1) ? '\n' : Delimiter;
         }
-        InputFile.close();
-    } else {
-        printf("Error opening Input file.\n");
     }
+    return static_cast<std::size_t>(p - Buf.data());
 }
 
-Array CsvClass::GetData(){
-    //A getter for Data variable
-    return this->Data;
-}
-
-void CsvClass::WriteData(Array data, std::string FilePath, char Delimiter){
-    //To Write to a file, it takes file path and the delimiter character.
-    std::fstream OutputFile(FilePath, std::ios::out);
-    char EndLine;
-
-    if (OutputFile.is_open()) {
-        printf("Writing to output file.\n");
-        for (int i = 0; i < data.size(); ++i) {
-        for (int j = 0; j < data[i].size(); ++j){
-            EndLine = (j == data[i].size() - 1) ? '\n':Delimiter;
-            OutputFile << data[i][j] << EndLine;
-            }
-        }
-    } else {
-        printf("Error in opening output file or in creating it.");
-    }
+// Row access for MedianFilter: rows of an Array, or gathered from the
+// columns of a mapped Matrix.
+std::size_t RowCount(const Array& In) { return In.size(); }
+std::size_t RowCount(const Matrix& In) { return In.Rows; }
+const std::vector<double>& RowOf(const Array& In, std::size_t i) { return In[i]; }
+std::vector<double> RowOf(const Matrix& In, std::size_t i) {
+    std::vector<double> Row(In.Cols);
+    for (std::size_t j = 0; j < In.Cols; ++j)
+        Row[j] = In(i, j);
+    return Row;
 }
 
-Array CsvClass::FilterData(){
-    // Applies a filter to eliminate Zero values.
-    // Interpolation of correct values is based on a median filtering.
-
-    Array FData = this -> Data;
+// The median filter of FilterData. Rows are copied from In just before the
+// first window that reads them, so the output is the only copy made.
+template <class Source>
+Array MedianFilter(const Source& In) {
+    const int Rows = static_cast<int>(RowCount(In));
+    Array FData;
+    FData.reserve(Rows);
     std::vector<double> Window; // Sliding window m x n
     int MaxM, MinM, MaxN, MinN; // Sliding window limits
     std::vector<std::pair<int, int> > ZStack; // A stack for bad values indexes
@@ -68,11 +64,14 @@ Array CsvClass::FilterData(){
     int mid; // Index of median value
 
     //General loop to iterate all array elements
-    for (int i = 0; i < FData.size(); ++i) {
+    for (int i = 0; i < Rows; ++i) {
+    // The windows of row i reach down to row i + 1.
+    while (FData.size() < static_cast<std::size_t>(std::min(i + 2, Rows)))
+        FData.push_back(RowOf(In, FData.size()));
     for (int j = 0; j < FData[i].size(); ++j) {
 
     // Calculating the limits the sliding window
-    MaxM = (i + 2 < FData.size()) ? i + 2 : FData.size();
+    MaxM = (i + 2 < Rows) ? i + 2 : Rows;
     MinM = (i - 1 >= 0) ? i - 1 : 0;
     MaxN = (j + 2 < FData[i].size()) ? j + 2 : FData[i].size();
     MinN = (j - 1 >= 0) ? j - 1 : 0;
@@ -127,3 +126,109 @@ Array CsvClass::FilterData(){
 
     return FData;
 }
+
+} // namespace
+
+// CsvClass Constructor & Destructor
+CsvClass::CsvClass() {}
+CsvClass::~CsvClass() {}
+
+void CsvClass::ReadData(std::string InputFilePath, char Delim, bool UseCache) {
+    //To Read from a file. It takes the file path and the delimiter character.
+    //With UseCache the parsed values are kept in "<path>.cache" and later runs
+    //map that file instead of parsing the text again. The cache is rebuilt
+    //whenever the CSV size or modification time or the delimiter changes.
+    this->Data.clear();
+    this->Cache.Close();
+    std::string CachePath = CsvCache::CachePathFor(InputFilePath);
+    if (UseCache && this->Cache.Open(CachePath, InputFilePath, Delim)) {
+        printf("Input cache is mapped.\n");
+        return;
+    }
+
+    //The text is parsed in parallel byte ranges, see CsvParse.hpp.
+    csvparse::Stats Info;
+    if (csvparse::ParseFile(InputFilePath, Delim, this->Data, &Info)) {
+        printf("Input file is opened.\n");
+        if (Info.BadFields != 0)
+            printf("%zu fields are not numbers, they are read as 0.\n", Info.BadFields);
+        if (UseCache) {
+            if (CsvCache::Write(this->Data, CachePath, InputFilePath, Delim)
+                && this->Cache.Open(CachePath, InputFilePath, Delim)) {
+                printf("Input cache is written.\n");
+            } else {
+                printf("Error writing input cache.\n");
+            }
+        }
+    } else {
+        printf("Error opening Input file.\n");
+    }
+}
+
+Array CsvClass::GetData(){
+    //A getter for Data variable
+    //On a cache hit only the mapped view exists, so it is copied out.
+    if (this->Data.empty() && this->Cache.IsOpen())
+        return this->Cache.GetMatrix().ToArray();
+    return this->Data;
+}
+
+Matrix CsvClass::GetMatrix(){
+    //Zero-copy view of the mapped cache, empty if ReadData did not use it.
+    return this->Cache.GetMatrix();
+}
+
+void CsvClass::WriteData(const Array& data, std::string FilePath, char Delimiter){
+    //To Write to a file, it takes file path and the delimiter character.
+    //Values are written in their shortest round-trip form, so ReadData gets
+    //back the exact same doubles. Blocks of rows are formatted in parallel
+    //into reusable buffers and written in order, one write per block.
+    std::fstream OutputFile(FilePath, std::ios::out | std::ios::binary);
+    if (!OutputFile.is_open()) {
+        printf("Error in opening output file or in creating it.");
+        return;
+    }
+    printf("Writing to output file.\n");
+
+    const std::size_t Blocks = (data.size() + RowsPerBlock - 1) / RowsPerBlock;
+    WorkStealingPool& Pool = WorkStealingPool::shared();
+    if (Pool.size() <= 1 || Blocks <= 1) {
+        std::vector<char> Buf;
+        for (std::size_t b = 0; b < Blocks; ++b) {
+            std::size_t Size = FormatRows(data, b, Delimiter, Buf);
+            OutputFile.write(Buf.data(), Size);
+        }
+        return;
+    }
+
+    // Window of 2 buffers per worker: block b is formatted by a pool task
+    // into slot b % Slots once block b - Slots has been written out here.
+    // Waiting on a block runs other format tasks meanwhile.
+    const std::size_t Slots = std::min<std::size_t>(2 * Pool.size(), Blocks);
+    std::vector<std::vector<char> > Bufs(Slots);
+    std::vector<std::future<std::size_t> > Sizes(Slots);
+    auto Format = [&](std::size_t b) {
+        std::vector<char>& Buf = Bufs[b % Slots];
+        Sizes[b % Slots] = Pool.submit([&data, &Buf, b, Delimiter] {
+            return FormatRows(data, b, Delimiter, Buf);
+        });
+    };
+    for (std::size_t b = 0; b < Slots; ++b)
+        Format(b);
+    for (std::size_t b = 0; b < Blocks; ++b) {
+        const std::size_t Size = Pool.wait(Sizes[b % Slots]);
+        OutputFile.write(Bufs[b % Slots].data(), Size);
+        if (b + Slots < Blocks)
+            Format(b + Slots);
+    }
+}
+
+Array CsvClass::FilterData(){
+    // Applies a filter to eliminate Zero values.
+    // Interpolation of correct values is based on a median filtering.
+    // Reads the mapped cache directly when there is one.
+    Matrix M = GetMatrix();
+    if (!M.Empty())
+        return MedianFilter(M);
+    return MedianFilter(this->Data);
+}
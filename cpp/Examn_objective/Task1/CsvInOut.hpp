@@ -10,6 +10,8 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include "CsvCache.hpp"
+#include "NeighbourhoodFilter.hpp"
 //==============================================================================
 // Type definitions:
 // We can use "using" too.
@@ -18,13 +20,27 @@ typedef std::vector< std::vector<double> > Array;
 
 class CsvClass{
     Array Data;
+    CsvCache Cache; // Mapped binary copy of the last CSV read with UseCache
  public:
      CsvClass();
-     void ReadData(std::string FilePath, char Delimiter = ';');
+     void ReadData(std::string FilePath, char Delimiter = ';', bool UseCache = false);
      Array FilterData();
-     void WriteData(Array data, std::string FilePath, char Delimiter = ';');
+     // K x K smoothing of the whole grid, e.g. ApplyFilter<5, filters::Mean>()
+     template <int K, template <int> class Reduction>
+     Array ApplyFilter();
+     void WriteData(const Array& data, std::string FilePath, char Delimiter = ';');
      Array GetData();
+     Matrix GetMatrix();
      ~CsvClass();
 };
 
+template <int K, template <int> class Reduction>
+Array CsvClass::ApplyFilter(){
+    // Works on the mapped cache directly when there is one.
+    Matrix M = GetMatrix();
+    if (!M.Empty())
+        return filters::Apply<K, Reduction>(M);
+    return filters::Apply<K, Reduction>(this->Data);
+}
+
 #endif // ifndef CSVINOUT_HPP
@@ -0,0 +1,179 @@
+// Implementation file for the parallel CSV parser -Task1App
+// Author: Salah Eddine Ghamri
+//==============================================================================
+#include "CsvParse.hpp"
+#include "../../multithreading/work_stealing_pool.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+//==============================================================================
+
+namespace csvparse {
+
+namespace {
+// Lenient like std::stod: leading blanks, a '+' sign and trailing blanks.
+bool ToDouble(const char* First, const char* Last, double& Value) {
+    while (First < Last && (*First == ' ' || *First == '\t')) ++First;
+    while (Last > First && (Last[-1] == ' ' || Last[-1] == '\t')) --Last;
+    if (First < Last && *First == '+') ++First;
+    std::from_chars_result r = std::from_chars(First, Last, Value);
+    return First < Last && r.ec == std::errc() && r.ptr == Last;
+}
+
+std::size_t CountQuotes(const char* Text, std::size_t Begin, std::size_t End) {
+    return static_cast<std::size_t>(std::count(Text + Begin, Text + End, '"'));
+}
+} // namespace
+
+std::size_t NextRecord(const char* Text, std::size_t Size, std::size_t Pos, bool InQuotes) {
+    for (; Pos < Size; ++Pos) {
+        if (Text[Pos] == '"') {
+            InQuotes = !InQuotes;
+        } else if (!InQuotes && Text[Pos] == '\n') {
+            return Pos + 1;
+        } else if (!InQuotes) {
+            // Jump to the next quote or newline, whichever comes first.
+            const void* nl = std::memchr(Text + Pos, '\n', Size - Pos);
+            const void* q = std::memchr(Text + Pos, '"', Size - Pos);
+            std::size_t Next = Size;
+            if (nl) Next = static_cast<const char*>(nl) - Text;
+            if (q) Next = std::min<std::size_t>(Next, static_cast<const char*>(q) - Text);
+            Pos = Next - 1;
+        }
+    }
+    return Size;
+}
+
+std::size_t ParseRange(const char* Text, std::size_t Begin, std::size_t End,
+                       char Delim, Grid& Out) {
+    std::size_t BadFields = 0;
+    std::vector<double> Row;
+    std::string Unquoted;
+    std::size_t Pos = Begin;
+    while (Pos < End) {
+        // One record per iteration; Pos is at the start of a field.
+        Row.clear();
+        for (;;) {
+            double Value = 0.0;
+            bool Ok;
+            std::size_t Stop;
+            if (Text[Pos] == '"') {
+                Unquoted.clear();
+                std::size_t p = Pos + 1;
+                while (p < End) {
+                    if (Text[p] == '"') {
+                        if (p + 1 < End && Text[p + 1] == '"') {
+                            Unquoted.push_back('"');
+                            p += 2;
+                            continue;
+                        }
+                        ++p;
+                        break;
+                    }
+                    Unquoted.push_back(Text[p++]);
+                }
+                Stop = p;
+                while (Stop < End && Text[Stop] != Delim && Text[Stop] != '\n') ++Stop;
+                Ok = ToDouble(Unquoted.data(), Unquoted.data() + Unquoted.size(), Value);
+            } else {
+                Stop = Pos;
+                while (Stop < End && Text[Stop] != Delim && Text[Stop] != '\n') ++Stop;
+                std::size_t Last = Stop;
+                if (Last > Pos && Text[Last - 1] == '\r') --Last;
+                Ok = ToDouble(Text + Pos, Text + Last, Value);
+                if (!Ok && Last == Pos && (Stop == End || Text[Stop] == '\n')) {
+                    // Empty last field: getline does not report it either.
+                    Pos = Stop;
+                    break;
+                }
+            }
+            if (!Ok) ++BadFields;
+            Row.push_back(Ok ? Value : 0.0);
+            Pos = Stop;
+            if (Pos >= End || Text[Pos] == '\n') break;
+            ++Pos; // skip the delimiter
+            if (Pos >= End) break;
+        }
+        Out.push_back(Row);
+        if (Pos < End && Text[Pos] == '\n') ++Pos;
+    }
+    return BadFields;
+}
+
+bool ParseFile(const std::string& Path, char Delim, Grid& Out, Stats* Info, unsigned Threads) {
+    int fd = open(Path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    const std::size_t Size = static_cast<std::size_t>(st.st_size);
+    Stats Local;
+    Local.Bytes = Size;
+    if (Size == 0) {
+        close(fd);
+        if (Info) *Info = Local;
+        return true;
+    }
+    void* Map = mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (Map == MAP_FAILED) return false;
+    madvise(Map, Size, MADV_SEQUENTIAL);
+    const char* Text = static_cast<const char*>(Map);
+
+    WorkStealingPool& Pool = WorkStealingPool::shared();
+    if (Threads == 0) Threads = Pool.size();
+    Threads = static_cast<unsigned>(std::max<std::size_t>(1,
+        std::min<std::size_t>(Threads, Size / MinBytesPerThread)));
+    Local.Threads = Threads;
+
+    std::vector<std::size_t> Cut(Threads + 1);
+    for (unsigned t = 0; t <= Threads; ++t)
+        Cut[t] = Size / Threads * t;
+    Cut[Threads] = Size;
+
+    // Pass 1: quote parity of each range.
+    std::vector<std::size_t> Quotes(Threads);
+    Pool.parallel_for(0, Threads, [&](std::size_t t) {
+        Quotes[t] = CountQuotes(Text, Cut[t], Cut[t + 1]);
+    }, 1);
+
+    // Pass 2: quote state at each cut, then parse every range into a block.
+    std::vector<bool> InQuotes(Threads + 1, false);
+    for (unsigned t = 1; t <= Threads; ++t)
+        InQuotes[t] = InQuotes[t - 1] != (Quotes[t - 1] % 2 == 1);
+    // Both ends of a range are found the same way by the two threads that
+    // share them, so no record is lost or parsed twice.
+    auto Boundary = [&](unsigned t) {
+        return (t == 0) ? 0 : (t == Threads) ? Size
+                         : NextRecord(Text, Size, Cut[t], InQuotes[t]);
+    };
+    std::vector<Grid> Blocks(Threads);
+    std::vector<std::size_t> Bad(Threads, 0);
+    auto Parse = [&](unsigned t) {
+        std::size_t Begin = Boundary(t);
+        std::size_t End = std::max(Begin, Boundary(t + 1));
+        Bad[t] = ParseRange(Text, Begin, End, Delim, Blocks[t]);
+    };
+    Pool.parallel_for(0, Threads, [&](std::size_t t) { Parse(static_cast<unsigned>(t)); }, 1);
+    munmap(Map, Size);
+
+    // Stitch the blocks in file order.
+    std::size_t Rows = Out.size();
+    for (const Grid& B : Blocks) Rows += B.size();
+    Out.reserve(Rows);
+    for (unsigned t = 0; t < Threads; ++t) {
+        for (std::vector<double>& Row : Blocks[t])
+            Out.push_back(std::move(Row));
+        Local.BadFields += Bad[t];
+    }
+    if (Info) *Info = Local;
+    return true;
+}
+
+} // namespace csvparse
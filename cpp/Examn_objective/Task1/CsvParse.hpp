@@ -0,0 +1,51 @@
+// Header file of the parallel CSV parser - Task1App
+// Author: Salah Eddine Ghamri
+#ifndef CSVPARSE_HPP
+#define CSVPARSE_HPP
+
+//==============================================================================
+// Included dependencies:
+#include <cstddef>
+#include <string>
+#include <vector>
+//==============================================================================
+// The file is mapped and cut into one byte range per thread. A field quoted
+// with '"' may contain the delimiter, newlines and "" escapes, so a range
+// cannot just start after the next '\n'. The parser therefore works in two
+// passes:
+//   1. every thread counts the quotes in its range; a prefix XOR of those
+//      parities tells each range whether it starts inside a quoted field;
+//   2. every thread skips to the first newline that is outside quotes (its
+//      first real record), parses up to the next range's first record into
+//      a local block, and the blocks are stitched together in file order.
+// Fields that are not numbers are stored as 0, which FilterData repairs.
+//==============================================================================
+
+namespace csvparse {
+
+using Grid = std::vector< std::vector<double> >;
+
+// Ranges smaller than this are not worth a thread of their own.
+const std::size_t MinBytesPerThread = 1 << 20;
+
+struct Stats {
+    std::size_t Bytes = 0;
+    std::size_t BadFields = 0; // fields stored as 0 because they are not numbers
+    unsigned Threads = 0;
+};
+
+// Parses Path into Out (one row per record). The file is cut into Threads
+// ranges parsed on WorkStealingPool::shared(); 0 gives one per worker.
+bool ParseFile(const std::string& Path, char Delim, Grid& Out,
+               Stats* Info = nullptr, unsigned Threads = 0);
+
+// Parses the records of Text[Begin, End); Begin must be a record start.
+std::size_t ParseRange(const char* Text, std::size_t Begin, std::size_t End,
+                       char Delim, Grid& Out);
+
+// First record start at or after Pos, given whether Pos is inside quotes.
+std::size_t NextRecord(const char* Text, std::size_t Size, std::size_t Pos, bool InQuotes);
+
+} // namespace csvparse
+
+#endif // ifndef CSVPARSE_HPP
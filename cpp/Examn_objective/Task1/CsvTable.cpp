@@ -0,0 +1,538 @@
+// Implementation file for CsvTable -Task1App
+// Author: Salah Eddine Ghamri
+//==============================================================================
+#include "CsvTable.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+//==============================================================================
+
+namespace {
+bool IsBlank(char c) { return c == ' ' || c == '\t'; }
+
+// An empty or all-blank field is a missing value.
+bool IsMissingField(std::string_view Field) {
+    return std::all_of(Field.begin(), Field.end(), IsBlank);
+}
+
+// Lenient like std::stod in CsvClass: leading and trailing blanks and a
+// '+' sign are skipped, since std::from_chars takes none of them.
+std::string_view NumberText(std::string_view Field) {
+    while (!Field.empty() && IsBlank(Field.front())) Field.remove_prefix(1);
+    while (!Field.empty() && IsBlank(Field.back())) Field.remove_suffix(1);
+    if (Field.size() > 1 && Field[0] == '+' && Field[1] != '-') Field.remove_prefix(1);
+    return Field;
+}
+
+bool ParseInt(std::string_view Field, std::int64_t& Value) {
+    Field = NumberText(Field);
+    const char* End = Field.data() + Field.size();
+    std::from_chars_result r = std::from_chars(Field.data(), End, Value);
+    return !Field.empty() && r.ec == std::errc() && r.ptr == End;
+}
+
+bool ParseDouble(std::string_view Field, double& Value) {
+    Field = NumberText(Field);
+    const char* End = Field.data() + Field.size();
+    std::from_chars_result r = std::from_chars(Field.data(), End, Value);
+    return !Field.empty() && r.ec == std::errc() && r.ptr == End;
+}
+
+bool FitsInt32(std::int64_t v) {
+    return v >= std::numeric_limits<std::int32_t>::min()
+        && v <= std::numeric_limits<std::int32_t>::max();
+}
+
+bool FloatExact(double d) {
+    return static_cast<double>(static_cast<float>(d)) == d;
+}
+
+// Integers up to 2^53 in magnitude are exact in a double.
+bool DoubleExact(std::int64_t v) {
+    const std::int64_t Limit = std::int64_t(1) << 53;
+    return v >= -Limit && v <= Limit;
+}
+
+bool AllDoubleExact(const std::vector<std::int64_t>& Values) {
+    for (std::int64_t v : Values)
+        if (!DoubleExact(v)) return false;
+    return true;
+}
+
+// A number that a double holds without rounding an integer.
+bool FitsDouble(std::string_view Field, double& Value) {
+    std::int64_t i;
+    return ParseDouble(Field, Value) && !(ParseInt(Field, i) && !DoubleExact(i));
+}
+
+// Splits Line on Delim into Fields (views into Line).
+void SplitLine(std::string_view Line, char Delim, std::vector<std::string_view>& Fields) {
+    Fields.clear();
+    if (!Line.empty() && Line.back() == '\r') Line.remove_suffix(1);
+    std::size_t Start = 0;
+    for (;;) {
+        std::size_t Pos = Line.find(Delim, Start);
+        if (Pos == std::string_view::npos) {
+            Fields.push_back(Line.substr(Start));
+            return;
+        }
+        Fields.push_back(Line.substr(Start, Pos - Start));
+        Start = Pos + 1;
+    }
+}
+
+// Type guess for one column from the sample rows.
+struct Guess {
+    bool AllInt = true, AllInt32 = true, AllFloatExact = true, AllDoubleExact = true;
+    bool AnyText = false;
+
+    void Add(std::string_view Field) {
+        std::int64_t i;
+        double d;
+        if (IsMissingField(Field)) return;
+        if (ParseInt(Field, i)) {
+            AllInt32 = AllInt32 && FitsInt32(i);
+            AllFloatExact = AllFloatExact && FloatExact(static_cast<double>(i));
+            AllDoubleExact = AllDoubleExact && DoubleExact(i);
+        } else if (ParseDouble(Field, d)) {
+            AllInt = false;
+            AllFloatExact = AllFloatExact && FloatExact(d);
+        } else {
+            AnyText = true;
+        }
+    }
+    ColumnType Type() const {
+        if (AnyText) return ColumnType::String;
+        if (AllInt) return AllInt32 ? ColumnType::Int32 : ColumnType::Int64;
+        if (!AllDoubleExact) return ColumnType::String; // big ids next to fractions
+        return AllFloatExact ? ColumnType::Float32 : ColumnType::Float64;
+    }
+};
+
+std::uint32_t Encode(Column& Col, std::string_view Field) {
+    std::string Key(Field);
+    auto it = Col.Lookup.find(Key);
+    if (it != Col.Lookup.end()) return it->second;
+    std::uint32_t Code = static_cast<std::uint32_t>(Col.Dictionary.size());
+    Col.Dictionary.push_back(Key);
+    Col.Lookup.emplace(std::move(Key), Code);
+    return Code;
+}
+
+template <class T>
+void EncodeAll(Column& Col, const std::vector<T>& Values) {
+    char Buf[32];
+    for (std::size_t Row = 0; Row < Values.size(); ++Row) {
+        if (Col.IsMissing(Row)) {
+            Col.Codes.push_back(Column::NoCode);
+            continue;
+        }
+        char* End = std::to_chars(Buf, Buf + sizeof(Buf), Values[Row]).ptr;
+        Col.Codes.push_back(Encode(Col, std::string_view(Buf, End - Buf)));
+    }
+}
+
+template <class From, class To>
+void Widen(const std::vector<From>& In, std::vector<To>& Out) {
+    Out.reserve(In.size() + 1);
+    for (From v : In) Out.push_back(static_cast<To>(v));
+}
+
+// Converts the values stored so far to a wider type.
+void Promote(Column& Col, ColumnType To) {
+    if (To == ColumnType::String) {
+        switch (Col.Type) {
+            case ColumnType::Int32:   EncodeAll(Col, Col.I32); break;
+            case ColumnType::Int64:   EncodeAll(Col, Col.I64); break;
+            case ColumnType::Float32: EncodeAll(Col, Col.F32); break;
+            case ColumnType::Float64: EncodeAll(Col, Col.F64); break;
+            case ColumnType::String:  break;
+        }
+    } else if (To == ColumnType::Int64) {
+        Widen(Col.I32, Col.I64);
+    } else if (To == ColumnType::Float64) {
+        switch (Col.Type) {
+            case ColumnType::Int32:   Widen(Col.I32, Col.F64); break;
+            case ColumnType::Int64:   Widen(Col.I64, Col.F64); break;
+            case ColumnType::Float32: Widen(Col.F32, Col.F64); break;
+            default: break;
+        }
+    }
+    std::vector<std::int32_t>().swap(Col.I32);
+    if (To != ColumnType::Int64) std::vector<std::int64_t>().swap(Col.I64);
+    std::vector<float>().swap(Col.F32);
+    if (To != ColumnType::Float64) std::vector<double>().swap(Col.F64);
+    Col.Type = To;
+}
+
+// Branch-free selection: every row is written, only matches advance n.
+template <class T, class Pred>
+void Select(const std::vector<T>& Values, Pred p, std::vector<std::uint32_t>& Out) {
+    Out.resize(Values.size());
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < Values.size(); ++i) {
+        Out[n] = static_cast<std::uint32_t>(i);
+        n += p(Values[i]) ? 1 : 0;
+    }
+    Out.resize(n);
+}
+
+// Removes the missing rows of Col from a Select result.
+void DropMissing(const Column& Col, std::vector<std::uint32_t>& Rows) {
+    if (Col.Missing.empty()) return;
+    Rows.erase(std::remove_if(Rows.begin(), Rows.end(),
+                              [&](std::uint32_t r) { return Col.Missing[r] != 0; }),
+               Rows.end());
+}
+
+// Median of a window the way CsvClass::FilterData computes it: half a
+// selection sort, then the element at (n + 1) / 2, or the mean of the two
+// elements around it when n is even.
+double WindowMedian(std::vector<double>& Window) {
+    const std::size_t n = Window.size();
+    const std::size_t Mid = (n + 1) / 2;
+    for (std::size_t e = 0; e <= Mid && e < n; ++e) {
+        std::size_t Min = e;
+        for (std::size_t k = e + 1; k < n; ++k)
+            if (Window[k] < Window[Min]) Min = k;
+        std::swap(Window[e], Window[Min]);
+    }
+    if (n % 2 != 0) return Window[std::min(Mid, n - 1)];
+    return (Window[Mid - 1] + Window[Mid]) / 2;
+}
+
+// Writes v into a numeric column, widening it when v does not fit.
+void Store(Column& Col, std::size_t Row, double v) {
+    if (Row < Col.Missing.size()) Col.Missing[Row] = 0;
+    const bool Integral = std::floor(v) == v;
+    switch (Col.Type) {
+        case ColumnType::Int32:
+            if (Integral && v >= std::numeric_limits<std::int32_t>::min()
+                && v <= std::numeric_limits<std::int32_t>::max()) {
+                Col.I32[Row] = static_cast<std::int32_t>(v);
+                return;
+            }
+            Promote(Col, Integral && std::fabs(v) < 0x1p63 ? ColumnType::Int64 : ColumnType::Float64);
+            break;
+        case ColumnType::Int64:
+            if (Integral && std::fabs(v) < 0x1p63) {
+                Col.I64[Row] = static_cast<std::int64_t>(v);
+                return;
+            }
+            if (!AllDoubleExact(Col.I64)) {
+                // Widening would round the other values: round this one.
+                Col.I64[Row] = std::fabs(v) < 0x1p63 ? std::llround(v)
+                             : v < 0 ? std::numeric_limits<std::int64_t>::min()
+                                     : std::numeric_limits<std::int64_t>::max();
+                return;
+            }
+            Promote(Col, ColumnType::Float64);
+            break;
+        case ColumnType::Float32:
+            if (FloatExact(v)) {
+                Col.F32[Row] = static_cast<float>(v);
+                return;
+            }
+            Promote(Col, ColumnType::Float64);
+            break;
+        case ColumnType::Float64:
+            Col.F64[Row] = v;
+            return;
+        case ColumnType::String:
+            return;
+    }
+    Store(Col, Row, v); // retry with the widened type
+}
+} // namespace
+
+const char* ColumnTypeName(ColumnType Type) {
+    switch (Type) {
+        case ColumnType::Int32:   return "int32";
+        case ColumnType::Int64:   return "int64";
+        case ColumnType::Float32: return "float";
+        case ColumnType::Float64: return "double";
+        case ColumnType::String:  return "string";
+    }
+    return "?";
+}
+
+//==============================================================================
+// Column
+//==============================================================================
+
+std::size_t Column::Size() const {
+    switch (Type) {
+        case ColumnType::Int32:   return I32.size();
+        case ColumnType::Int64:   return I64.size();
+        case ColumnType::Float32: return F32.size();
+        case ColumnType::Float64: return F64.size();
+        case ColumnType::String:  return Codes.size();
+    }
+    return 0;
+}
+
+std::size_t Column::MemoryBytes() const {
+    std::size_t Bytes = I32.capacity() * sizeof(std::int32_t)
+                      + I64.capacity() * sizeof(std::int64_t)
+                      + F32.capacity() * sizeof(float)
+                      + F64.capacity() * sizeof(double)
+                      + Codes.capacity() * sizeof(std::uint32_t)
+                      + Missing.capacity();
+    for (const std::string& s : Dictionary)
+        Bytes += sizeof(std::string) + s.capacity();
+    // Lookup holds a second copy of each key plus a node per entry.
+    for (const std::string& s : Dictionary)
+        Bytes += sizeof(std::string) + s.capacity() + 2 * sizeof(void*) + sizeof(std::uint32_t);
+    return Bytes;
+}
+
+bool Column::IsMissing(std::size_t Row) const {
+    return Row < Missing.size() && Missing[Row] != 0;
+}
+
+double Column::AsDouble(std::size_t Row) const {
+    switch (Type) {
+        case ColumnType::Int32:   return I32[Row];
+        case ColumnType::Int64:   return static_cast<double>(I64[Row]);
+        case ColumnType::Float32: return F32[Row];
+        case ColumnType::Float64: return F64[Row];
+        case ColumnType::String:  break;
+    }
+    return 0.0;
+}
+
+//==============================================================================
+// CsvTable
+//==============================================================================
+
+// CsvTable Constructor & Destructor
+CsvTable::CsvTable() : Rows(0) {}
+CsvTable::~CsvTable() {}
+
+std::size_t CsvTable::RowCount() const { return Rows; }
+std::size_t CsvTable::ColumnCount() const { return Columns.size(); }
+const Column& CsvTable::GetColumn(std::size_t Col) const { return Columns[Col]; }
+
+std::size_t CsvTable::MemoryBytes() const {
+    std::size_t Bytes = 0;
+    for (const Column& C : Columns) Bytes += C.MemoryBytes();
+    return Bytes;
+}
+
+void CsvTable::Append(Column& Col, std::string_view Field) {
+    std::int64_t i;
+    double d;
+    switch (Col.Type) {
+        case ColumnType::Int32:
+            if (ParseInt(Field, i) && FitsInt32(i)) {
+                Col.I32.push_back(static_cast<std::int32_t>(i));
+                return;
+            }
+            Promote(Col, ParseInt(Field, i) ? ColumnType::Int64
+                       : ParseDouble(Field, d) ? ColumnType::Float64
+                       : ColumnType::String);
+            break;
+        case ColumnType::Int64:
+            if (ParseInt(Field, i)) {
+                Col.I64.push_back(i);
+                return;
+            }
+            Promote(Col, ParseDouble(Field, d) && AllDoubleExact(Col.I64)
+                         ? ColumnType::Float64 : ColumnType::String);
+            break;
+        case ColumnType::Float32:
+            if (ParseDouble(Field, d) && FloatExact(d)) {
+                Col.F32.push_back(static_cast<float>(d));
+                return;
+            }
+            Promote(Col, FitsDouble(Field, d) ? ColumnType::Float64 : ColumnType::String);
+            break;
+        case ColumnType::Float64:
+            if (FitsDouble(Field, d)) {
+                Col.F64.push_back(d);
+                return;
+            }
+            Promote(Col, ColumnType::String);
+            break;
+        case ColumnType::String:
+            Col.Codes.push_back(Encode(Col, Field));
+            return;
+    }
+    Append(Col, Field); // retry with the promoted type
+}
+
+void CsvTable::AppendField(Column& Col, std::string_view Field) {
+    const std::size_t Row = Col.Size();
+    if (!IsMissingField(Field)) {
+        Append(Col, Field);
+        if (!Col.Missing.empty()) Col.Missing.push_back(0);
+        return;
+    }
+    Col.Missing.resize(Row, 0);
+    Col.Missing.push_back(1);
+    switch (Col.Type) {
+        case ColumnType::Int32:   Col.I32.push_back(0); break;
+        case ColumnType::Int64:   Col.I64.push_back(0); break;
+        case ColumnType::Float32: Col.F32.push_back(0.0f); break;
+        case ColumnType::Float64: Col.F64.push_back(0.0); break;
+        case ColumnType::String:  Col.Codes.push_back(Column::NoCode); break;
+    }
+}
+
+void CsvTable::ReadData(std::string InputFilePath, char Delim) {
+    //To Read from a file. It takes the file path and the delimiter character.
+    Columns.clear();
+    Rows = 0;
+    std::fstream InputFile(InputFilePath, std::ios::in | std::ios::binary);
+    if (!InputFile.is_open()) {
+        printf("Error opening Input file.\n");
+        return;
+    }
+    printf("Input file is opened.\n");
+    std::string Text;
+    InputFile.seekg(0, std::ios::end);
+    Text.resize(static_cast<std::size_t>(InputFile.tellg()));
+    InputFile.seekg(0, std::ios::beg);
+    InputFile.read(&Text[0], Text.size());
+    InputFile.close();
+
+    std::vector<std::string_view> Lines;
+    std::string_view All(Text);
+    for (std::size_t Start = 0; Start < All.size();) {
+        std::size_t End = All.find('\n', Start);
+        if (End == std::string_view::npos) End = All.size();
+        Lines.push_back(All.substr(Start, End - Start));
+        Start = End + 1;
+    }
+    if (Lines.empty()) return;
+
+    // Infer the column types from the first SampleRows lines.
+    std::vector<std::string_view> Fields;
+    SplitLine(Lines[0], Delim, Fields);
+    std::vector<Guess> Guesses(Fields.size());
+    for (std::size_t l = 0; l < Lines.size() && l < SampleRows; ++l) {
+        SplitLine(Lines[l], Delim, Fields);
+        for (std::size_t c = 0; c < Guesses.size(); ++c)
+            Guesses[c].Add(c < Fields.size() ? Fields[c] : std::string_view());
+    }
+    Columns.resize(Guesses.size());
+    for (std::size_t c = 0; c < Columns.size(); ++c) {
+        Column& C = Columns[c];
+        C.Type = Guesses[c].Type();
+        switch (C.Type) {
+            case ColumnType::Int32:   C.I32.reserve(Lines.size()); break;
+            case ColumnType::Int64:   C.I64.reserve(Lines.size()); break;
+            case ColumnType::Float32: C.F32.reserve(Lines.size()); break;
+            case ColumnType::Float64: C.F64.reserve(Lines.size()); break;
+            case ColumnType::String:  C.Codes.reserve(Lines.size()); break;
+        }
+    }
+
+    bool Ragged = false;
+    for (std::string_view Line : Lines) {
+        SplitLine(Line, Delim, Fields);
+        Ragged = Ragged || Fields.size() != Columns.size();
+        for (std::size_t c = 0; c < Columns.size(); ++c)
+            AppendField(Columns[c], c < Fields.size() ? Fields[c] : std::string_view());
+    }
+    Rows = Lines.size();
+    // A promotion mid-file leaves the new vector with doubling slack.
+    for (Column& C : Columns) {
+        C.I64.shrink_to_fit();
+        C.F64.shrink_to_fit();
+        C.Codes.shrink_to_fit();
+        C.Missing.shrink_to_fit();
+    }
+    if (Ragged)
+        printf("Some rows do not have %zu fields, missing ones are missing values.\n", Columns.size());
+}
+
+std::vector<std::uint32_t> CsvTable::Where(std::size_t Col, CompareOp Op, double Value) const {
+    // Compares each numeric value with Value; string columns match nothing.
+    std::vector<std::uint32_t> Out;
+    if (Columns[Col].Type == ColumnType::String) return Out;
+    Visit(Col, [&](const auto& Values) {
+        using T = typename std::decay_t<decltype(Values)>::value_type;
+        auto Cast = [](T v) { return static_cast<double>(v); };
+        switch (Op) {
+            case CompareOp::Less:         Select(Values, [&](T v) { return Cast(v) <  Value; }, Out); break;
+            case CompareOp::LessEqual:    Select(Values, [&](T v) { return Cast(v) <= Value; }, Out); break;
+            case CompareOp::Equal:        Select(Values, [&](T v) { return Cast(v) == Value; }, Out); break;
+            case CompareOp::NotEqual:     Select(Values, [&](T v) { return Cast(v) != Value; }, Out); break;
+            case CompareOp::GreaterEqual: Select(Values, [&](T v) { return Cast(v) >= Value; }, Out); break;
+            case CompareOp::Greater:      Select(Values, [&](T v) { return Cast(v) >  Value; }, Out); break;
+        }
+    });
+    DropMissing(Columns[Col], Out);
+    return Out;
+}
+
+std::vector<std::uint32_t> CsvTable::WhereEquals(std::size_t Col, std::string_view Value) const {
+    // On a string column the text is looked up once and only codes are scanned.
+    const Column& C = Columns[Col];
+    std::vector<std::uint32_t> Out;
+    if (C.Type != ColumnType::String) {
+        double d;
+        return ParseDouble(Value, d) ? Where(Col, CompareOp::Equal, d) : Out;
+    }
+    auto it = C.Lookup.find(std::string(Value));
+    if (it == C.Lookup.end()) return Out;
+    const std::uint32_t Code = it->second;
+    Select(C.Codes, [Code](std::uint32_t v) { return v == Code; }, Out);
+    return Out;
+}
+
+double CsvTable::Sum(std::size_t Col) const {
+    double Total = 0.0;
+    if (Columns[Col].Type == ColumnType::String) return Total;
+    Visit(Col, [&](const auto& Values) {
+        for (auto v : Values) Total += static_cast<double>(v);
+    });
+    return Total;
+}
+
+std::vector< std::vector<double> > CsvTable::ToArray() const {
+    std::vector< std::vector<double> > Out(Rows);
+    for (std::size_t i = 0; i < Rows; ++i)
+        for (const Column& C : Columns)
+            if (C.Type != ColumnType::String)
+                Out[i].push_back(C.AsDouble(i));
+    return Out;
+}
+
+std::size_t CsvTable::FilterData() {
+    // Same walk as CsvClass::FilterData over the grid of numeric columns:
+    // every 3 x 3 window holding zero (or missing) cells replaces them with
+    // its median, and later windows see the replaced values.
+    std::vector<Column*> Grid;
+    for (Column& C : Columns)
+        if (C.Type != ColumnType::String) Grid.push_back(&C);
+    const std::size_t Cols = Grid.size();
+    std::vector<double> Window;
+    std::vector<std::pair<std::size_t, std::size_t> > ZStack;
+    std::size_t Replaced = 0;
+    for (std::size_t i = 0; i < Rows; ++i) {
+        for (std::size_t j = 0; j < Cols; ++j) {
+            Window.clear();
+            ZStack.clear();
+            const std::size_t MaxM = std::min(i + 2, Rows), MaxN = std::min(j + 2, Cols);
+            for (std::size_t m = (i > 0 ? i - 1 : 0); m < MaxM; ++m) {
+                for (std::size_t n = (j > 0 ? j - 1 : 0); n < MaxN; ++n) {
+                    const double v = Grid[n]->AsDouble(m);
+                    if (v == 0) ZStack.emplace_back(m, n);
+                    Window.push_back(v);
+                }
+            }
+            if (ZStack.empty()) continue;
+            const double MedValue = WindowMedian(Window);
+            for (const auto& Z : ZStack)
+                Store(*Grid[Z.second], Z.first, MedValue);
+            if (MedValue != 0) Replaced += ZStack.size();
+        }
+    }
+    return Replaced;
+}
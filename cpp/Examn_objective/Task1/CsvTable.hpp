@@ -0,0 +1,105 @@
+// Header file of CsvTable - Task1App
+// Author: Salah Eddine Ghamri
+#ifndef CSVTABLE_HPP
+#define CSVTABLE_HPP
+
+//==============================================================================
+// Included dependencies:
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+//==============================================================================
+// Columnar, typed counterpart of CsvClass. Each column keeps its values in
+// one contiguous vector of the narrowest type inferred from a sample of the
+// file; text columns are dictionary-encoded as uint32 codes. A value that
+// does not fit the inferred type later in the file promotes its column
+// (int32 -> int64 -> double -> string), so inference never loses data: an
+// int64 column only becomes double while all of its values are exact in a
+// double (|v| <= 2^53), otherwise it becomes string.
+//
+// Numbers are read like std::stod reads them in CsvClass: blanks around the
+// value and a leading '+' are accepted. An empty or all-blank field is a
+// missing value, whatever the column type: it does not influence inference,
+// is stored as 0 (code NoCode in string columns) and is flagged in
+// Column::Missing. Scans never match missing rows.
+//==============================================================================
+
+enum class ColumnType : std::uint8_t { Int32, Int64, Float32, Float64, String };
+
+const char* ColumnTypeName(ColumnType Type);
+
+struct Column {
+    ColumnType Type = ColumnType::Int32;
+    // Only the vector matching Type is used.
+    std::vector<std::int32_t> I32;
+    std::vector<std::int64_t> I64;
+    std::vector<float> F32;
+    std::vector<double> F64;
+    std::vector<std::uint32_t> Codes;        // String: index into Dictionary
+    std::vector<std::string> Dictionary;     // String: distinct values
+    std::unordered_map<std::string, std::uint32_t> Lookup; // value -> code
+    // One flag per row once the column has a missing value, empty before.
+    std::vector<std::uint8_t> Missing;
+
+    static constexpr std::uint32_t NoCode = 0xffffffffu;
+
+    std::size_t Size() const;
+    std::size_t MemoryBytes() const;
+    bool IsMissing(std::size_t Row) const;
+    double AsDouble(std::size_t Row) const;  // numeric columns only, 0 if missing
+};
+
+enum class CompareOp { Less, LessEqual, Equal, NotEqual, GreaterEqual, Greater };
+
+class CsvTable{
+    std::vector<Column> Columns;
+    std::size_t Rows;
+
+    void Append(Column& Col, std::string_view Field);
+    void AppendField(Column& Col, std::string_view Field);
+ public:
+     // Rows read to guess the column types before the full parse.
+     static const std::size_t SampleRows = 1000;
+
+     CsvTable();
+     void ReadData(std::string FilePath, char Delimiter = ';');
+     std::size_t RowCount() const;
+     std::size_t ColumnCount() const;
+     const Column& GetColumn(std::size_t Col) const;
+     std::size_t MemoryBytes() const;
+
+     // Calls f with the typed vector of a numeric column.
+     template <class F>
+     void Visit(std::size_t Col, F f) const;
+
+     // Column scans. Where returns the indexes of the matching rows.
+     std::vector<std::uint32_t> Where(std::size_t Col, CompareOp Op, double Value) const;
+     std::vector<std::uint32_t> WhereEquals(std::size_t Col, std::string_view Value) const;
+     double Sum(std::size_t Col) const;
+
+     // CsvClass::FilterData on the numeric columns, in place: zero and
+     // missing cells get the median of their 3 x 3 window. Reads each
+     // column in its own type; a column is widened only when a median does
+     // not fit it. Returns the number of cells replaced.
+     std::size_t FilterData();
+
+     // Numeric columns as the row-wise Array used by CsvClass::FilterData.
+     std::vector< std::vector<double> > ToArray() const;
+     ~CsvTable();
+};
+
+template <class F>
+void CsvTable::Visit(std::size_t Col, F f) const {
+    const Column& C = Columns[Col];
+    switch (C.Type) {
+        case ColumnType::Int32:   f(C.I32); break;
+        case ColumnType::Int64:   f(C.I64); break;
+        case ColumnType::Float32: f(C.F32); break;
+        case ColumnType::Float64: f(C.F64); break;
+        case ColumnType::String:  f(C.Codes); break;
+    }
+}
+
+#endif // ifndef CSVTABLE_HPP
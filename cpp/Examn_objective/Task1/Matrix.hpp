@@ -0,0 +1,40 @@
+// Header file of Matrix view - Task1App
+// Author: Salah Eddine Ghamri
+#ifndef MATRIX_HPP
+#define MATRIX_HPP
+
+//==============================================================================
+// Included dependencies:
+#include <cstddef>
+#include <vector>
+//==============================================================================
+
+// A non-owning view over a column-major block of doubles.
+// Each column starts at Data + j * ColStride, so with a ColStride multiple of
+// 8 every column is 64-byte aligned when Data is.
+// The view never frees memory: whoever produced it (CsvCache) keeps it alive.
+struct Matrix {
+    const double* Data = nullptr;
+    std::size_t Rows = 0;
+    std::size_t Cols = 0;
+    std::size_t ColStride = 0; // distance in doubles between two columns
+
+    double operator()(std::size_t i, std::size_t j) const {
+        return Data[j * ColStride + i];
+    }
+    const double* Column(std::size_t j) const { return Data + j * ColStride; }
+    bool Empty() const { return Data == nullptr || Rows == 0 || Cols == 0; }
+
+    // Copies the view back into the row-wise Array layout of CsvClass.
+    std::vector< std::vector<double> > ToArray() const {
+        std::vector< std::vector<double> > out(Rows, std::vector<double>(Cols));
+        for (std::size_t j = 0; j < Cols; ++j) {
+            const double* col = Column(j);
+            for (std::size_t i = 0; i < Rows; ++i)
+                out[i][j] = col[i];
+        }
+        return out;
+    }
+};
+
+#endif // ifndef MATRIX_HPP
@@ -0,0 +1,237 @@
+// Header file of the k x k neighbourhood filters - Task1App
+// Author: Salah Eddine Ghamri
+#ifndef NEIGHBOURHOODFILTER_HPP
+#define NEIGHBOURHOODFILTER_HPP
+
+//==============================================================================
+// Included dependencies:
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "Matrix.hpp"
+//==============================================================================
+// Usage:
+//     Array Smooth = filters::Apply<5, filters::Gaussian>(Data);
+//     Array Clean  = filters::Apply<7, filters::Median>(Data);
+//
+// The grid is first copied into a padded buffer with a border of K/2 cells
+// replicating the edge values. Every output cell then sees a full K x K
+// window, so the reductions below loop over compile-time bounds with no
+// clamping or bounds checks.
+//
+// A reduction is a class template on K that derives from PerWindow (CRTP)
+// and provides Reduce(window, stride); it may instead provide its own Run()
+// when it can reuse work between neighbouring windows (see Median).
+//==============================================================================
+
+namespace filters {
+
+using Grid = std::vector< std::vector<double> >;
+
+// Row-major copy of the input with an R cell border on each side.
+struct Padded {
+    std::vector<double> Buf;
+    std::size_t Rows = 0, Cols = 0; // size of the original grid
+    std::size_t Stride = 0;         // Cols + 2R
+    std::size_t R = 0;
+
+    // Top-left corner of the window centred on original cell (i, j).
+    const double* Window(std::size_t i, std::size_t j) const {
+        return Buf.data() + i * Stride + j;
+    }
+};
+
+// Builds the padded buffer from anything indexable as src(i, j).
+template <class Getter>
+Padded MakePadded(std::size_t Rows, std::size_t Cols, std::size_t R, Getter src) {
+    Padded p;
+    p.Rows = Rows;
+    p.Cols = Cols;
+    p.R = R;
+    p.Stride = Cols + 2 * R;
+    p.Buf.resize((Rows + 2 * R) * p.Stride);
+    for (std::size_t pi = 0; pi < Rows + 2 * R; ++pi) {
+        // Clamp into the grid: border cells replicate the nearest edge cell.
+        std::size_t i = (pi < R) ? 0 : std::min(pi - R, Rows - 1);
+        double* out = p.Buf.data() + pi * p.Stride;
+        for (std::size_t pj = 0; pj < p.Stride; ++pj) {
+            std::size_t j = (pj < R) ? 0 : std::min(pj - R, Cols - 1);
+            out[pj] = src(i, j);
+        }
+    }
+    return p;
+}
+
+// CRTP base: evaluates Derived::Reduce on every window independently.
+template <class Derived, int K>
+struct PerWindow {
+    static void Run(const Padded& p, Grid& out) {
+        for (std::size_t i = 0; i < p.Rows; ++i)
+            for (std::size_t j = 0; j < p.Cols; ++j)
+                out[i][j] = Derived::Reduce(p.Window(i, j), p.Stride);
+    }
+};
+
+//==============================================================================
+// Reductions
+//==============================================================================
+
+template <int K>
+struct Mean : PerWindow<Mean<K>, K> {
+    static double Reduce(const double* w, std::size_t stride) {
+        double sum = 0.0;
+        for (int m = 0; m < K; ++m, w += stride)
+            for (int n = 0; n < K; ++n)
+                sum += w[n];
+        return sum / (K * K);
+    }
+};
+
+// Binomial weights are the discrete approximation of a Gaussian whose
+// variance grows with K: (K-1)/4 per axis. Computed at compile time.
+template <int K>
+struct Gaussian : PerWindow<Gaussian<K>, K> {
+    static constexpr std::array<double, K> Weights() {
+        std::array<double, K> row{};
+        row[0] = 1.0;
+        for (int n = 1; n < K; ++n)
+            for (int k = n; k > 0; --k)
+                row[k] += row[k - 1];
+        double total = 0.0;
+        for (int n = 0; n < K; ++n) total += row[n];
+        for (int n = 0; n < K; ++n) row[n] /= total;
+        return row;
+    }
+    static double Reduce(const double* w, std::size_t stride) {
+        constexpr std::array<double, K> g = Weights();
+        double sum = 0.0;
+        for (int m = 0; m < K; ++m, w += stride) {
+            double rowSum = 0.0;
+            for (int n = 0; n < K; ++n)
+                rowSum += g[n] * w[n];
+            sum += g[m] * rowSum;
+        }
+        return sum;
+    }
+};
+
+// Windows up to this size are solved with nth_element on a stack copy;
+// bigger ones use the sliding rank histogram in Median::Run.
+constexpr int SlidingMedianFrom = 7;
+
+template <int K>
+struct Median : PerWindow<Median<K>, K> {
+    static double Reduce(const double* w, std::size_t stride) {
+        std::array<double, K * K> v;
+        for (int m = 0; m < K; ++m, w += stride)
+            for (int n = 0; n < K; ++n)
+                v[m * K + n] = w[n];
+        auto mid = v.begin() + (K * K) / 2;
+        std::nth_element(v.begin(), mid, v.end());
+        return *mid;
+    }
+
+    // Sliding median: values are replaced by their rank among the distinct
+    // values of the grid and counted in a Fenwick tree. The window snakes
+    // through the grid, so each step removes and adds K cells, and the median
+    // is found by a binary descent: O(K log U) per cell instead of O(K^2).
+    static void Run(const Padded& p, Grid& out) {
+        if constexpr (K < SlidingMedianFrom) {
+            PerWindow<Median<K>, K>::Run(p, out);
+            return;
+        }
+        std::vector<double> Values(p.Buf);
+        std::sort(Values.begin(), Values.end());
+        Values.erase(std::unique(Values.begin(), Values.end()), Values.end());
+        std::vector<std::uint32_t> Rank(p.Buf.size());
+        for (std::size_t c = 0; c < p.Buf.size(); ++c)
+            Rank[c] = static_cast<std::uint32_t>(
+                std::lower_bound(Values.begin(), Values.end(), p.Buf[c]) - Values.begin());
+
+        const std::size_t U = Values.size();
+        std::vector<std::int32_t> Tree(U + 1, 0);
+        std::size_t Top = 1;
+        while (Top * 2 <= U) Top *= 2;
+        auto Add = [&](std::size_t pi, std::size_t pj, std::int32_t d) {
+            for (std::size_t r = Rank[pi * p.Stride + pj] + 1; r <= U; r += r & (~r + 1))
+                Tree[r] += d;
+        };
+        auto Select = [&](std::int32_t k) { // rank with k smaller elements
+            std::size_t pos = 0;
+            for (std::size_t step = Top; step; step >>= 1)
+                if (pos + step <= U && Tree[pos + step] <= k) {
+                    pos += step;
+                    k -= Tree[pos];
+                }
+            return Values[pos];
+        };
+        const std::int32_t Half = (K * K) / 2;
+
+        for (std::size_t m = 0; m < K; ++m)
+            for (std::size_t n = 0; n < K; ++n)
+                Add(m, n, +1);
+        for (std::size_t i = 0; i < p.Rows; ++i) {
+            if (i > 0) { // slide down at the current end column
+                std::size_t j0 = (i % 2 == 1) ? p.Cols - 1 : 0;
+                for (std::size_t n = 0; n < K; ++n) {
+                    Add(i - 1, j0 + n, -1);
+                    Add(i + K - 1, j0 + n, +1);
+                }
+            }
+            bool Forward = (i % 2 == 0);
+            for (std::size_t s = 0; s < p.Cols; ++s) {
+                std::size_t j = Forward ? s : p.Cols - 1 - s;
+                if (s > 0) { // slide one column left or right
+                    std::size_t Leaving = Forward ? j - 1 : j + K;
+                    std::size_t Entering = Forward ? j + K - 1 : j;
+                    for (std::size_t m = 0; m < K; ++m) {
+                        Add(i + m, Leaving, -1);
+                        Add(i + m, Entering, +1);
+                    }
+                }
+                out[i][j] = Select(Half);
+            }
+        }
+    }
+};
+
+//==============================================================================
+// Engine
+//==============================================================================
+
+template <int K, template <int> class Reduction>
+Grid ApplyPadded(const Padded& p) {
+    Grid out(p.Rows, std::vector<double>(p.Cols));
+    Reduction<K>::Run(p, out);
+    return out;
+}
+
+template <int K, template <int> class Reduction>
+Grid Apply(const Grid& data) {
+    static_assert(K % 2 == 1 && K > 0, "Kernel size must be odd");
+    if (data.empty() || data[0].empty()) return Grid();
+    for (const std::vector<double>& row : data)
+        if (row.size() != data[0].size()) {
+            printf("Ragged rows, filter not applied.\n");
+            return Grid();
+        }
+    Padded p = MakePadded(data.size(), data[0].size(), K / 2,
+        [&](std::size_t i, std::size_t j) { return data[i][j]; });
+    return ApplyPadded<K, Reduction>(p);
+}
+
+template <int K, template <int> class Reduction>
+Grid Apply(const Matrix& data) {
+    static_assert(K % 2 == 1 && K > 0, "Kernel size must be odd");
+    if (data.Empty()) return Grid();
+    Padded p = MakePadded(data.Rows, data.Cols, K / 2,
+        [&](std::size_t i, std::size_t j) { return data(i, j); });
+    return ApplyPadded<K, Reduction>(p);
+}
+
+} // namespace filters
+
+#endif // ifndef NEIGHBOURHOODFILTER_HPP
@@ -0,0 +1,51 @@
+/*==============================================================================
+# Title           : bench_read.cpp of Task1App
+# Description     : Measures the parse throughput of csvparse::ParseFile
+#                   (used by CsvClass::ReadData) from 1 thread to every core.
+# Usage           : g++ -std=c++17 -O2 -pthread bench_read.cpp CsvParse.cpp
+#                       -o bench_read
+#                   ./bench_read [rows] [cols]
+# C++_version     : C++17
+# ==============================================================================
+*/
+#include "CsvParse.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+int main(int args, char** argv) {
+    std::size_t Rows = (args > 1) ? std::stoul(argv[1]) : 2000000;
+    std::size_t Cols = (args > 2) ? std::stoul(argv[2]) : 8;
+    const char* Path = "bench_read.csv";
+
+    std::mt19937_64 Gen(42);
+    std::uniform_real_distribution<double> Dist(-1e3, 1e3);
+    FILE* f = std::fopen(Path, "w");
+    if (!f) return EXIT_FAILURE;
+    for (std::size_t i = 0; i < Rows; ++i)
+        for (std::size_t j = 0; j < Cols; ++j)
+            std::fprintf(f, "%.6f%c", Dist(Gen), (j + 1 == Cols) ? '\n' : ';');
+    std::fclose(f);
+
+    unsigned Cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> Counts;
+    for (unsigned t = 1; t < Cores; t *= 2) Counts.push_back(t);
+    Counts.push_back(Cores);
+    double Base = 0.0;
+    for (unsigned t : Counts) {
+        csvparse::Grid Out;
+        csvparse::Stats Info;
+        auto t0 = std::chrono::steady_clock::now();
+        csvparse::ParseFile(Path, ';', Out, &Info, t);
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        double MBs = Info.Bytes / 1e6 / s;
+        if (t == 1) Base = MBs;
+        printf("%3u threads: %8.1f MB/s (x%.2f), %zu rows\n", Info.Threads, MBs, MBs / Base, Out.size());
+    }
+    std::remove(Path);
+    return EXIT_SUCCESS;
+}
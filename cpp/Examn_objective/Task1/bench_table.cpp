@@ -0,0 +1,89 @@
+/*==============================================================================
+# Title           : bench_table.cpp of Task1App
+# Description     : Loads the same sensor file into CsvClass (rows of
+#                   doubles) and CsvTable (typed columns), compares their
+#                   memory and FilterData time, and checks that both filters
+#                   give the same values.
+# Usage           : g++ -std=c++17 -O2 -pthread bench_table.cpp CsvTable.cpp
+#                       CsvInOut.cpp CsvParse.cpp CsvCache.cpp -o bench_table
+#                   ./bench_table [rows]
+# C++_version     : C++17
+# ==============================================================================
+*/
+#include "CsvInOut.hpp"
+#include "CsvTable.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+// id;timestamp_ns;reading;status, about 2% of the readings are 0 and
+// another 1% are empty. With Label a text column is appended.
+void WriteSensorFile(const char* Path, std::size_t Rows, bool Label) {
+    static const char* Labels[] = {"ok", "warm", "hot", "offline"};
+    std::mt19937_64 Gen(42);
+    std::uniform_int_distribution<int> Quarter(-4000, 4000);
+    std::uniform_int_distribution<int> Percent(0, 99);
+    FILE* f = std::fopen(Path, "w");
+    if (!f) std::exit(EXIT_FAILURE);
+    for (std::size_t i = 0; i < Rows; ++i) {
+        const int p = Percent(Gen);
+        std::fprintf(f, "%zu;%lld;", i, 1700000000000000000LL + static_cast<long long>(i) * 1000003);
+        if (p >= 3) std::fprintf(f, "%g", Quarter(Gen) * 0.25);
+        else if (p >= 1) std::fprintf(f, "0");
+        std::fprintf(f, ";%d", 1 + p % 4);
+        if (Label) std::fprintf(f, ";%s", Labels[p % 4]);
+        std::fprintf(f, "\n");
+    }
+    std::fclose(f);
+}
+
+std::size_t ArrayBytes(const Array& A) {
+    std::size_t Bytes = A.capacity() * sizeof(std::vector<double>);
+    for (const std::vector<double>& Row : A) Bytes += Row.capacity() * sizeof(double);
+    return Bytes;
+}
+
+template <class F>
+double Seconds(F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+} // namespace
+
+int main(int args, char** argv) {
+    std::size_t Rows = (args > 1) ? std::stoul(argv[1]) : 1000000;
+    const char* Path = "bench_table.csv";
+    WriteSensorFile(Path, Rows, false);
+
+    CsvClass Rowwise;
+    CsvTable Table;
+    Rowwise.ReadData(Path);
+    Table.ReadData(Path);
+    const std::size_t RowBytes = ArrayBytes(Rowwise.GetData());
+    printf("%zu rows, column types:", Table.RowCount());
+    for (std::size_t c = 0; c < Table.ColumnCount(); ++c)
+        printf(" %s", ColumnTypeName(Table.GetColumn(c).Type));
+    printf("\nCsvClass: %8.1f MB\nCsvTable: %8.1f MB (x%.2f)\n", RowBytes / 1e6,
+           Table.MemoryBytes() / 1e6, static_cast<double>(Table.MemoryBytes()) / RowBytes);
+
+    Array Filtered;
+    std::size_t Replaced = 0;
+    double RowSeconds = Seconds([&] { Filtered = Rowwise.FilterData(); });
+    double TableSeconds = Seconds([&] { Replaced = Table.FilterData(); });
+    const bool Same = (Filtered == Table.ToArray());
+    printf("FilterData: CsvClass %.3f s, CsvTable %.3f s, %zu cells replaced, %s\n",
+           RowSeconds, TableSeconds, Replaced, Same ? "same values" : "VALUES DIFFER!");
+
+    // Text next to the numbers: CsvClass would read it as 0.
+    WriteSensorFile(Path, Rows, true);
+    CsvTable Labelled;
+    Labelled.ReadData(Path);
+    const Column& Label = Labelled.GetColumn(Labelled.ColumnCount() - 1);
+    printf("With a label column: %.1f MB, %zu distinct labels\n",
+           Labelled.MemoryBytes() / 1e6, Label.Dictionary.size());
+    std::remove(Path);
+    return Same ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,70 @@
+/*==============================================================================
+# Title           : bench_write.cpp of Task1App
+# Description     : Compares CsvClass::WriteData with the original
+#                   operator<< writer and checks that the output reloads
+#                   bit-exact through CsvClass::ReadData.
+# Usage           : g++ -std=c++17 -O2 -pthread bench_write.cpp CsvInOut.cpp
+#                       CsvParse.cpp CsvCache.cpp -o bench_write
+#                   ./bench_write [rows] [cols]
+# C++_version     : C++17
+# ==============================================================================
+*/
+#include "CsvInOut.hpp"
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <sys/stat.h>
+
+// The writer WriteData replaced, kept for reference.
+void LegacyWriteData(const Array& data, std::string FilePath, char Delimiter){
+    std::fstream OutputFile(FilePath, std::ios::out);
+    char EndLine;
+    for (std::size_t i = 0; i < data.size(); ++i) {
+    for (std::size_t j = 0; j < data[i].size(); ++j){
+        EndLine = (j == data[i].size() - 1) ? '\n':Delimiter;
+        OutputFile << data[i][j] << EndLine;
+        }
+    }
+}
+
+double FileMB(const std::string& Path){
+    struct stat st;
+    return (stat(Path.c_str(), &st) == 0) ? st.st_size / 1e6 : 0.0;
+}
+
+template <class F>
+double Seconds(F f){
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int args, char** argv) {
+    std::size_t Rows = (args > 1) ? std::stoul(argv[1]) : 200000;
+    std::size_t Cols = (args > 2) ? std::stoul(argv[2]) : 10;
+
+    std::mt19937_64 Gen(42);
+    std::uniform_real_distribution<double> Dist(-1e6, 1e6);
+    Array Data(Rows, std::vector<double>(Cols));
+    for (auto& Row : Data)
+        for (auto& v : Row)
+            v = Dist(Gen);
+
+    CsvClass Csv;
+    double tOld = Seconds([&] { LegacyWriteData(Data, "bench_legacy.csv", ';'); });
+    double tNew = Seconds([&] { Csv.WriteData(Data, "bench_new.csv"); });
+    double mbOld = FileMB("bench_legacy.csv"), mbNew = FileMB("bench_new.csv");
+    printf("legacy  : %8.1f MB in %.3f s = %8.1f MB/s (6 digits, lossy)\n",
+           mbOld, tOld, mbOld / tOld);
+    printf("WriteData: %8.1f MB in %.3f s = %8.1f MB/s\n", mbNew, tNew, mbNew / tNew);
+
+    Csv.ReadData("bench_new.csv");
+    Array Back = Csv.GetData();
+    bool Exact = Back.size() == Data.size();
+    for (std::size_t i = 0; Exact && i < Rows; ++i)
+        Exact = std::memcmp(Back[i].data(), Data[i].data(), Cols * sizeof(double)) == 0;
+    printf("Reload is %s.\n", Exact ? "bit-exact" : "NOT bit-exact");
+    std::remove("bench_legacy.csv");
+    std::remove("bench_new.csv");
+    return Exact ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -10,6 +10,8 @@
 # Version         : 1.0
 # Usage           : Compile using Cmake.
 # Notes           : Main takes two inputs: input file path and output file path.
+#                   An optional third input "--cache" keeps a binary copy of
+#                   the input next to it (<input>.cache) for faster reruns.
 # C++_version     : C++14
 # //TODO          : ...
 # ==============================================================================
@@ -23,14 +25,15 @@ CsvClass Data;
 int main(int args, char** argv) {
     // Main takes two inputs: input file path and output file path.
     // Argument number verification
-    if (args == 3) {
+    bool UseCache = (args == 4 && std::string(argv[3]) == "--cache");
+    if (args == 3 || UseCache) {
         printf("'OK' Arguments provided.\n");
     } else {
         printf("Missing main arguments.\n");
         return EXIT_FAILURE;
     }
     //Assigne the input file path.
-    Data.ReadData(argv[1]);
+    Data.ReadData(argv[1], ';', UseCache);
     //use GetData method to retrieve data
     //Write to a file the filtered data
     Data.WriteData(Data.FilterData(), argv[2]);
@@ -0,0 +1,194 @@
+// counters.cpp
+// Complete C++17 tutorial and demo: how a shared counter scales with threads
+// (mutex, atomic, sharded, thread-local batching; see counters.hpp)
+// Compile: g++ -std=c++17 -Wall -Wextra -O2 -pthread counters.cpp -o counters
+// Run: ./counters [max_threads]
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include "counters.hpp"
+
+/*
+example1.cpp protects myAmount with a mutex, locked and unlocked by hand.
+That is correct for two threads adding once. A counter on a hot path (requests
+served, bytes sent, cache hits) gets added to millions of times per second
+from every core, and then the question is how the cost grows with threads.
+
+This demo runs the four counters of counters.hpp:
+
+1. Add throughput: each of T threads (T = 1, 2, 4 ... and max_threads
+   itself, default: the core count) adds its share of 20 million events;
+   prints millions of adds per second
+2. Read cost: how long value() takes while T other threads keep adding (a
+   counter is read while it is hot, or nobody would care), and how far the
+   batched counter lags before its threads flush
+
+Interesting facts & pitfalls:
+- A std::atomic is not free: every fetch_add needs the cache line in
+  exclusive state, so with many cores the line bounces between them and
+  adds become as slow as a cache miss each.
+- Two atomics in the same cache line contend just like one (false
+  sharing), which is why every shard is alignas(64).
+- On a machine with fewer cores than threads, the threads take turns and
+  contention mostly disappears; run with max_threads at most the core
+  count to see the real scaling.
+- Pick per metric: rare events or exact values read often -> AtomicCounter;
+  hot events read now and then (metrics scrape) -> ShardedCounter; hottest
+  loops that can tolerate a lagging total -> BatchedCounter.
+*/
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::uint64_t total_adds = 20000000;
+
+// Runs body(thread_index, adds) on `threads` threads started together; returns seconds.
+template <class Body>
+double run_threads(int threads, Body body) {
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> pool;
+    const std::uint64_t each = total_adds / threads;
+    for (int t = 0; t < threads; ++t)
+        pool.emplace_back([&, t] {
+            ready.fetch_add(1);
+            while (!go.load()) std::this_thread::yield();
+            body(t, each);
+        });
+    while (ready.load() < threads) std::this_thread::yield();
+    auto t0 = Clock::now();
+    go.store(true);
+    for (auto& th : pool) th.join();
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+template <class F>
+double ns_per_call(F f, int calls) {
+    auto t0 = Clock::now();
+    for (int i = 0; i < calls; ++i) f();
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / calls;
+}
+
+// ns per counter.value() on this thread while `writers` threads run
+// write(stop) until stop is set.
+template <class Counter, class Write>
+double read_ns_under_load(const Counter& counter, int writers, Write write) {
+    std::atomic<bool> stop{false};
+    std::atomic<int> running{0};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < writers; ++t)
+        pool.emplace_back([&] {
+            running.fetch_add(1);
+            write(stop);
+        });
+    while (running.load() < writers) std::this_thread::yield();
+    volatile std::uint64_t sink = 0;
+    const double ns = ns_per_call([&] { sink = sink + counter.value(); }, 200000);
+    stop.store(true);
+    for (auto& th : pool) th.join();
+    return ns;
+}
+
+// 1, 2, 4 ... below max_threads, then max_threads itself.
+std::vector<int> thread_counts(int max_threads) {
+    std::vector<int> counts;
+    for (int t = 1; t < max_threads; t *= 2) counts.push_back(t);
+    counts.push_back(max_threads);
+    return counts;
+}
+
+int main(int argc, char* argv[]) {
+    int max_threads = argc > 1 ? std::atoi(argv[1]) : static_cast<int>(std::thread::hardware_concurrency());
+    if (max_threads < 1) max_threads = 1;
+    const std::vector<int> counts = thread_counts(max_threads);
+    bool ok = true;
+
+    // --------------------------------------------------------------------
+    // 1. Add throughput
+    // --------------------------------------------------------------------
+    std::printf("=== Step 1: Adds per second (millions), %llu adds in total ===\n",
+                static_cast<unsigned long long>(total_adds));
+    std::printf("%7s %10s %10s %10s %10s\n", "threads", "mutex", "atomic", "sharded", "batched");
+    for (int threads : counts) {
+        const std::uint64_t expected = total_adds / threads * threads;
+        MutexCounter mutex_counter;
+        AtomicCounter atomic_counter;
+        ShardedCounter sharded_counter(static_cast<std::size_t>(max_threads));
+        BatchedCounter batched_counter;
+
+        double s_mutex = run_threads(threads, [&](int, std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) mutex_counter.add();
+        });
+        double s_atomic = run_threads(threads, [&](int, std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) atomic_counter.add();
+        });
+        double s_sharded = run_threads(threads, [&](int, std::uint64_t n) {
+            for (std::uint64_t i = 0; i < n; ++i) sharded_counter.add();
+        });
+        double s_batched = run_threads(threads, [&](int, std::uint64_t n) {
+            BatchedCounter::Local local(batched_counter);
+            for (std::uint64_t i = 0; i < n; ++i) local.add();
+        });
+        auto rate = [&](double s) { return expected / s / 1e6; };
+        std::printf("%7d %10.1f %10.1f %10.1f %10.1f\n", threads, rate(s_mutex), rate(s_atomic), rate(s_sharded),
+                    rate(s_batched));
+        ok = ok && mutex_counter.value() == expected && atomic_counter.value() == expected &&
+             sharded_counter.value() == expected && batched_counter.value() == expected;
+    }
+    std::printf("%s\n\n", ok ? "all counters exact after join" : "COUNTS DIFFER!");
+
+    // --------------------------------------------------------------------
+    // 2. Read cost
+    // --------------------------------------------------------------------
+    std::printf("=== Step 2: ns per value() while T threads add ===\n");
+    std::printf("%7s %10s %10s %10s %10s\n", "writers", "mutex", "atomic", "sharded", "batched");
+    for (int writers : counts) {
+        MutexCounter mutex_counter;
+        AtomicCounter atomic_counter;
+        ShardedCounter sharded_counter(static_cast<std::size_t>(max_threads));
+        BatchedCounter batched_counter;
+        const double r_mutex = read_ns_under_load(mutex_counter, writers, [&](const std::atomic<bool>& stop) {
+            while (!stop.load(std::memory_order_relaxed)) mutex_counter.add();
+        });
+        const double r_atomic = read_ns_under_load(atomic_counter, writers, [&](const std::atomic<bool>& stop) {
+            while (!stop.load(std::memory_order_relaxed)) atomic_counter.add();
+        });
+        const double r_sharded = read_ns_under_load(sharded_counter, writers, [&](const std::atomic<bool>& stop) {
+            while (!stop.load(std::memory_order_relaxed)) sharded_counter.add();
+        });
+        const double r_batched = read_ns_under_load(batched_counter, writers, [&](const std::atomic<bool>& stop) {
+            BatchedCounter::Local local(batched_counter);
+            while (!stop.load(std::memory_order_relaxed)) local.add();
+        });
+        std::printf("%7d %10.1f %10.1f %10.1f %10.1f\n", writers, r_mutex, r_atomic, r_sharded, r_batched);
+    }
+    std::printf("(sharded reads %zu shards, each one a cache miss when another core writes it)\n\n",
+                ShardedCounter(static_cast<std::size_t>(max_threads)).shards());
+
+    BatchedCounter batched_counter;
+
+    // Lag: 4 threads add 1000 events each and wait before destroying their Local.
+    std::atomic<int> added{0};
+    std::atomic<bool> done{false};
+    std::vector<std::thread> pool;
+    for (int t = 0; t < 4; ++t)
+        pool.emplace_back([&] {
+            BatchedCounter::Local local(batched_counter);
+            for (int i = 0; i < 1000; ++i) local.add();
+            added.fetch_add(1);
+            while (!done.load()) std::this_thread::yield();
+        });
+    while (added.load() < 4) std::this_thread::yield();
+    const std::uint64_t before = batched_counter.value();
+    done.store(true);
+    for (auto& th : pool) th.join();
+    std::printf("batched lag: 4000 added, value() %llu before the threads flushed, %llu after\n",
+                static_cast<unsigned long long>(before),
+                static_cast<unsigned long long>(batched_counter.value()));
+    ok = ok && before == 0 && batched_counter.value() == 4000;
+    return ok ? 0 : 1;
+}
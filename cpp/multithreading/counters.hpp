@@ -0,0 +1,133 @@
+// counters.hpp
+// Four thread-safe event counters with the same add() / value() interface,
+// from simplest to most scalable.
+//
+//   MutexCounter     ++ under a std::mutex (what example1.cpp does)
+//   AtomicCounter    one std::atomic, fetch_add
+//   ShardedCounter   one atomic per cache line, each thread adds to "its"
+//                    line, value() sums the lines
+//   BatchedCounter   each thread counts in a plain local variable (a
+//                    BatchedCounter::Local) and adds the total to a shared
+//                    atomic every flush_every events and when it goes away
+//
+// What each costs (see counters.cpp for numbers):
+//   - MutexCounter and AtomicCounter serialize every add() on one cache
+//     line. That is fine for a few threads and rare events, and collapses
+//     when many cores hit the same counter.
+//   - ShardedCounter adds scale with threads as long as there are at least
+//     as many shards as threads. value() reads every shard: it is slower,
+//     and not a snapshot (adds running meanwhile may or may not be seen).
+//   - BatchedCounter adds are a plain increment, but value() lags by up to
+//     flush_every events per thread until the threads flush.
+//
+// All counts use memory_order_relaxed: a counter says how many events
+// happened, it does not order other memory. Do not use one of these to
+// signal "the data is ready".
+
+#ifndef COUNTERS_HPP
+#define COUNTERS_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+class MutexCounter {
+public:
+    void add(std::uint64_t n = 1) {
+        std::lock_guard<std::mutex> lock(m_);  // unlike m.lock()/m.unlock(), safe if the body throws
+        value_ += n;
+    }
+    std::uint64_t value() const {
+        std::lock_guard<std::mutex> lock(m_);
+        return value_;
+    }
+
+private:
+    mutable std::mutex m_;
+    std::uint64_t value_ = 0;
+};
+
+class AtomicCounter {
+public:
+    void add(std::uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    std::uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<std::uint64_t> value_{0};
+};
+
+class ShardedCounter {
+public:
+    // shards: rounded up to a power of two; default one per hardware thread.
+    explicit ShardedCounter(std::size_t shards = std::thread::hardware_concurrency()) {
+        std::size_t n = 1;
+        while (n < shards) n *= 2;
+        mask_ = n - 1;
+        shards_.reset(new Shard[n]);
+    }
+
+    void add(std::uint64_t n = 1) { shards_[thread_index() & mask_].value.fetch_add(n, std::memory_order_relaxed); }
+
+    std::uint64_t value() const {
+        std::uint64_t sum = 0;
+        for (std::size_t i = 0; i <= mask_; ++i) sum += shards_[i].value.load(std::memory_order_relaxed);
+        return sum;
+    }
+
+    std::size_t shards() const { return mask_ + 1; }
+
+private:
+    struct alignas(64) Shard {  // one cache line each, so shards never share one
+        std::atomic<std::uint64_t> value{0};
+    };
+    std::unique_ptr<Shard[]> shards_;
+    std::size_t mask_ = 0;
+
+    // 0, 1, 2... in the order threads first add to any ShardedCounter.
+    static std::size_t thread_index() {
+        static std::atomic<std::size_t> next{0};
+        thread_local const std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+};
+
+class BatchedCounter {
+public:
+    // One per thread:  BatchedCounter::Local hits(counter);  ... hits.add();
+    class Local {
+    public:
+        explicit Local(BatchedCounter& c) : c_(c) {}
+        ~Local() { flush(); }
+        Local(const Local&) = delete;
+        Local& operator=(const Local&) = delete;
+
+        void add(std::uint64_t n = 1) {
+            pending_ += n;
+            if (++events_ >= c_.flush_every_) flush();
+        }
+        void flush() {
+            if (pending_ != 0) c_.value_.fetch_add(pending_, std::memory_order_relaxed);
+            pending_ = 0;
+            events_ = 0;
+        }
+
+    private:
+        BatchedCounter& c_;
+        std::uint64_t pending_ = 0;
+        std::uint64_t events_ = 0;
+    };
+
+    explicit BatchedCounter(std::uint64_t flush_every = 1024) : flush_every_(flush_every ? flush_every : 1) {}
+
+    // Events flushed so far; each live Local may hold up to flush_every more.
+    std::uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    alignas(64) std::atomic<std::uint64_t> value_{0};
+    std::uint64_t flush_every_;
+};
+
+#endif // COUNTERS_HPP
@@ -0,0 +1,175 @@
+// mpmc_queue.cpp
+// Complete C++17 tutorial and demo: a bounded lock-free MPMC queue against
+// std::mutex + std::condition_variable + std::queue (see mpmc_queue.hpp)
+// Compile: g++ -std=c++17 -Wall -Wextra -O2 -pthread mpmc_queue.cpp -o mpmc_queue
+// Run: ./mpmc_queue [max_threads_per_side]
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mpmc_queue.hpp"
+
+/*
+9_stl_containers/queue.cpp notes that std::queue is not thread-safe and
+points to TBB or Boost. The usual standard-library answer is a std::queue
+guarded by a mutex, with condition variables for "not empty" and "not full".
+Every push and pop then takes the same lock, so producers and consumers all
+queue up behind each other.
+
+MpmcQueue (mpmc_queue.hpp) needs no lock unless a thread has to sleep. This
+demo:
+
+1. Passes 1000000 Messages (queue.cpp's sender + text, plus a sequence
+   number) from P producers to P consumers, P = 1, 2, 4 ... 16, through both
+   queues of capacity 1024, and prints millions of messages per second
+2. Checks that every message arrived exactly once and that each producer's
+   messages arrived in order at every consumer
+3. Shows try_push / try_pop on a full and an empty queue
+
+Interesting facts & pitfalls:
+- Both queues are bounded: a producer faster than its consumers waits
+  instead of growing memory without limit.
+- With more threads than cores, a thread can be descheduled between
+  claiming a cell and publishing it; the queue keeps working, but the
+  consumer of that cell waits for the producer to run again.
+- The numbers depend heavily on the core count; on a single core the
+  threads only take turns, and the gap between the queues is mostly the
+  cost of the lock itself.
+*/
+
+struct Message {
+    std::string sender;
+    std::string text;
+    std::uint64_t seq = 0;  // producer << 32 | index; ~0 tells a consumer to stop
+
+    Message() = default;
+    Message(std::string s, std::string t, std::uint64_t n) : sender(std::move(s)), text(std::move(t)), seq(n) {}
+};
+
+// The baseline: what most code does first.
+template <class T>
+class LockedQueue {
+public:
+    explicit LockedQueue(std::size_t capacity) : capacity_(capacity) {}
+    void push(T v) {
+        std::unique_lock<std::mutex> lock(m_);
+        not_full_.wait(lock, [&] { return q_.size() < capacity_; });
+        q_.push(std::move(v));
+        lock.unlock();
+        not_empty_.notify_one();
+    }
+    T pop() {
+        std::unique_lock<std::mutex> lock(m_);
+        not_empty_.wait(lock, [&] { return !q_.empty(); });
+        T v = std::move(q_.front());
+        q_.pop();
+        lock.unlock();
+        not_full_.notify_one();
+        return v;
+    }
+
+private:
+    std::mutex m_;
+    std::condition_variable not_full_, not_empty_;
+    std::queue<T> q_;
+    std::size_t capacity_;
+};
+
+constexpr std::uint64_t total = 1000000;
+constexpr std::uint64_t stop = ~std::uint64_t(0);
+
+struct Result {
+    double seconds = 0;
+    bool ok = true;
+};
+
+template <class Queue>
+Result run(Queue& q, int producers, int consumers) {
+    const std::uint64_t each = total / producers;
+    std::vector<std::vector<std::uint64_t>> last(consumers, std::vector<std::uint64_t>(producers, 0));
+    std::atomic<std::uint64_t> received{0}, checksum{0};
+    std::atomic<bool> in_order{true};
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int c = 0; c < consumers; ++c)
+        threads.emplace_back([&, c] {
+            std::uint64_t n = 0, sum = 0;
+            for (;;) {
+                Message m = q.pop();
+                if (m.seq == stop) break;
+                const std::uint64_t p = m.seq >> 32, i = m.seq & 0xffffffffu;
+                if (i + 1 <= last[c][p]) in_order = false;  // per-producer order
+                last[c][p] = i + 1;
+                ++n;
+                sum += m.seq;
+            }
+            received += n;
+            checksum += sum;
+        });
+    std::vector<std::thread> senders;
+    for (int p = 0; p < producers; ++p)
+        senders.emplace_back([&, p] {
+            const std::string name = "producer " + std::to_string(p);
+            for (std::uint64_t i = 0; i < each; ++i)
+                q.push(Message(name, "hello", (std::uint64_t(p) << 32) | i));
+        });
+    for (auto& t : senders) t.join();
+    for (int c = 0; c < consumers; ++c) q.push(Message("main", "stop", stop));
+    for (auto& t : threads) t.join();
+
+    Result r;
+    r.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::uint64_t expected = 0;
+    for (int p = 0; p < producers; ++p)
+        for (std::uint64_t i = 0; i < each; ++i) expected += (std::uint64_t(p) << 32) | i;
+    r.ok = received == each * producers && checksum == expected && in_order;
+    return r;
+}
+
+int main(int argc, char* argv[]) {
+    const int max_threads = argc > 1 ? std::atoi(argv[1]) : 16;
+    const std::size_t capacity = 1024;
+    bool ok = true;
+
+    // --------------------------------------------------------------------
+    // 1. + 2. Throughput and delivery
+    // --------------------------------------------------------------------
+    std::printf("=== Steps 1-2: %llu messages, capacity %zu, %u hardware threads ===\n",
+                static_cast<unsigned long long>(total), capacity, std::thread::hardware_concurrency());
+    std::printf("%10s %10s %16s %16s\n", "producers", "consumers", "mutex+cv M/s", "MpmcQueue M/s");
+    for (int p = 1; p <= max_threads; p *= 2) {
+        LockedQueue<Message> locked(capacity);
+        MpmcQueue<Message> lock_free(capacity);
+        Result a = run(locked, p, p);
+        Result b = run(lock_free, p, p);
+        std::printf("%10d %10d %16.2f %16.2f%s\n", p, p, total / a.seconds / 1e6, total / b.seconds / 1e6,
+                    a.ok && b.ok ? "" : "  LOST, DUPLICATED OR REORDERED!");
+        ok = ok && a.ok && b.ok;
+    }
+    std::printf("%s\n\n", ok ? "every message delivered once, in order per producer" : "DELIVERY FAILED");
+
+    // --------------------------------------------------------------------
+    // 3. Non-blocking calls
+    // --------------------------------------------------------------------
+    std::printf("=== Step 3: try_push / try_pop ===\n");
+    MpmcQueue<Message> small(4);
+    int pushed = 0;
+    while (small.try_push(Message("me", "fill", static_cast<std::uint64_t>(pushed)))) ++pushed;
+    Message m;
+    int popped = 0;
+    while (small.try_pop(m)) ++popped;
+    std::printf("capacity %zu: try_push succeeded %d times, then reported full; "
+                "try_pop returned %d, then reported empty\n",
+                small.capacity(), pushed, popped);
+    ok = ok && pushed == 4 && popped == 4 && m.seq == 3;
+    return ok ? 0 : 1;
+}
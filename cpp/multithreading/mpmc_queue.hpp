@@ -0,0 +1,186 @@
+// mpmc_queue.hpp
+// MpmcQueue<T>: a bounded multi-producer multi-consumer queue on a ring
+// buffer, lock-free on the fast path (the array queue of Dmitry Vyukov).
+//
+//   MpmcQueue<Message> q(1024);          // capacity rounded up to a power of two
+//   q.push(Message("alice", "hi"));      // producers, any number of threads:
+//   if (!q.try_push(m)) { ... full ... } //   push waits, try_push does not
+//   Message m = q.pop();                 // consumers, any number of threads:
+//   if (q.try_pop(m)) use(m);            //   pop waits, try_pop does not
+//
+// Every cell has a sequence number that says whose turn it is:
+//   seq == pos        free, for the producer that claims position pos
+//   seq == pos + 1    full, for the consumer that claims position pos
+// A producer reads the cell at the enqueue position; if it is free, it
+// claims the position with one compare-and-swap, constructs the element in
+// place and stores seq = pos + 1. Consumers do the mirror image and store
+// seq = pos + capacity, which frees the cell for the next lap. Producers
+// contend only on the enqueue counter, consumers only on the dequeue
+// counter, and the two counters live on different cache lines.
+//
+// push() and pop() spin briefly, then sleep on a condition variable until
+// the other side makes room or data. The other side only takes the mutex
+// to wake someone when a thread is actually sleeping.
+//
+// Pitfalls:
+// - FIFO per producer, but there is no global order between producers:
+//   two elements pushed "at the same time" may come out either way.
+// - size_approx() is a snapshot of two counters that keep moving.
+// - A producer preempted between claiming a cell and publishing it makes
+//   consumers of that cell wait for it (the queue is lock-free in practice,
+//   not in the strict sense).
+
+#ifndef MPMC_QUEUE_HPP
+#define MPMC_QUEUE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+
+template <class T>
+class MpmcQueue {
+public:
+    explicit MpmcQueue(std::size_t capacity) {
+        std::size_t n = 2;
+        while (n < capacity) n *= 2;
+        mask_ = n - 1;
+        cells_.reset(new Cell[n]);
+        for (std::size_t i = 0; i < n; ++i) cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+    ~MpmcQueue() {  // destroys what is left; no other thread may still use the queue
+        for (std::size_t pos = dequeue_.load(); pos != enqueue_.load(); ++pos)
+            std::launder(reinterpret_cast<T*>(&cells_[pos & mask_].storage))->~T();
+    }
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    std::size_t capacity() const { return mask_ + 1; }
+    std::size_t size_approx() const {
+        const std::size_t e = enqueue_.load(std::memory_order_relaxed);
+        const std::size_t d = dequeue_.load(std::memory_order_relaxed);
+        return e > d ? e - d : 0;
+    }
+
+    // Constructs T(args...) in the queue; false (args untouched) if full.
+    template <class... Args>
+    bool try_emplace(Args&&... args) {
+        std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const std::intptr_t dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (dif == 0) {
+                if (enqueue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false;  // the cell still holds last lap's element: full
+            } else {
+                pos = enqueue_.load(std::memory_order_relaxed);  // another producer took it
+            }
+        }
+        ::new (static_cast<void*>(&cell->storage)) T(std::forward<Args>(args)...);
+        cell->seq.store(pos + 1, std::memory_order_release);
+        wake(pop_waiters_, not_empty_);
+        return true;
+    }
+    bool try_push(const T& v) { return try_emplace(v); }
+    bool try_push(T&& v) { return try_emplace(std::move(v)); }
+
+    // Moves the oldest element into out; false if empty.
+    bool try_pop(T& out) {
+        std::size_t pos = dequeue_.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq = cell->seq.load(std::memory_order_acquire);
+            const std::intptr_t dif = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (dif == 0) {
+                if (dequeue_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false;  // not yet published: empty
+            } else {
+                pos = dequeue_.load(std::memory_order_relaxed);
+            }
+        }
+        T* elem = std::launder(reinterpret_cast<T*>(&cell->storage));
+        out = std::move(*elem);
+        elem->~T();
+        cell->seq.store(pos + mask_ + 1, std::memory_order_release);
+        wake(push_waiters_, not_full_);
+        return true;
+    }
+
+    // Blocking variants: wait while the queue is full / empty.
+    template <class... Args>
+    void emplace(Args&&... args) {
+        for (int spin = 0; !try_emplace(std::forward<Args>(args)...); ++spin)
+            backoff(spin, push_waiters_, not_full_, [this] { return !full(); });
+    }
+    void push(const T& v) { emplace(v); }
+    void push(T&& v) { emplace(std::move(v)); }
+
+    T pop() {
+        T out;
+        for (int spin = 0; !try_pop(out); ++spin)
+            backoff(spin, pop_waiters_, not_empty_, [this] { return !empty(); });
+        return out;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> seq;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_ = 0;
+    alignas(64) std::atomic<std::size_t> enqueue_{0};
+    alignas(64) std::atomic<std::size_t> dequeue_{0};
+    alignas(64) std::atomic<int> push_waiters_{0};
+    std::atomic<int> pop_waiters_{0};
+    std::mutex m_;
+    std::condition_variable not_full_, not_empty_;
+
+    // Cell at the next position not ready for the respective side.
+    bool full() const {
+        const std::size_t pos = enqueue_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].seq.load(std::memory_order_acquire) != pos;
+    }
+    bool empty() const {
+        const std::size_t pos = dequeue_.load(std::memory_order_relaxed);
+        return cells_[pos & mask_].seq.load(std::memory_order_acquire) != pos + 1;
+    }
+
+    // The fence pairs with the waiters_ increment in backoff(): either the
+    // sleeper sees our cell update, or we see the sleeper.
+    void wake(std::atomic<int>& waiters, std::condition_variable& cv) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(m_);
+            cv.notify_one();
+        }
+    }
+
+    template <class Ready>
+    void backoff(int spin, std::atomic<int>& waiters, std::condition_variable& cv, Ready ready) {
+        if (spin < 16) return;  // retry at once
+        if (spin < 64) {
+            std::this_thread::yield();
+            return;
+        }
+        std::unique_lock<std::mutex> lock(m_);
+        waiters.fetch_add(1);
+        // Timed, as a safety net: the predicate reads cells outside the mutex.
+        cv.wait_for(lock, std::chrono::milliseconds(1), ready);
+        waiters.fetch_sub(1);
+    }
+};
+
+#endif // MPMC_QUEUE_HPP
@@ -0,0 +1,142 @@
+// work_stealing_pool.cpp
+// Complete C++17 tutorial and demo: a work-stealing thread pool with futures,
+// parallel_for and nested parallelism (see work_stealing_pool.hpp)
+// Compile: g++ -std=c++17 -Wall -Wextra -O2 -pthread work_stealing_pool.cpp -o work_stealing_pool
+// Run: ./work_stealing_pool
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "work_stealing_pool.hpp"
+
+/*
+example1.cpp starts a std::thread per job. That is fine for two jobs; for
+thousands of small ones, creating a thread costs more than the job, and
+several libraries each starting "one thread per core" oversubscribe the
+machine. A pool keeps one thread per core and feeds it tasks.
+
+This demo:
+
+1. Runs 20000 small jobs with std::async (a thread each) and with submit()
+2. Runs a loop whose iterations get more expensive towards the end, split
+   into one static slice per thread and with parallel_for (work stealing)
+3. Computes fib(27) by recursive submit() + wait(), which would deadlock
+   with future.get() once every worker waits
+4. Shows that an exception thrown inside parallel_for reaches the caller
+
+Interesting facts & pitfalls:
+- With static slices the slowest slice decides the time; parallel_for cuts
+  the range in pieces and idle workers steal the biggest ones left.
+- A worker pops its newest task (LIFO, cache-warm) while thieves take the
+  oldest (FIFO), so owners and thieves rarely touch the same end.
+- wait() runs other tasks while waiting; recursion that deep in tasks also
+  uses the worker's stack, so keep nesting depth reasonable.
+*/
+
+using Clock = std::chrono::steady_clock;
+
+template <class F>
+double ms(F f) {
+    auto t0 = Clock::now();
+    f();
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+// About i * 200 floating-point operations.
+double work(std::size_t i) {
+    double x = 0;
+    for (std::size_t k = 0; k < i * 200 / 1000 + 1; ++k) x += std::sqrt(static_cast<double>(k + i));
+    return x;
+}
+
+long fib(WorkStealingPool& pool, int n) {
+    if (n < 2) return n;
+    if (n < 15) return fib(pool, n - 1) + fib(pool, n - 2);
+    std::future<long> left = pool.submit([&pool, n] { return fib(pool, n - 1); });
+    long right = fib(pool, n - 2);
+    return pool.wait(left) + right;
+}
+
+int main() {
+    WorkStealingPool& pool = WorkStealingPool::shared();
+    const unsigned threads = pool.size();
+    std::printf("%u workers\n\n", threads);
+    bool ok = true;
+
+    // --------------------------------------------------------------------
+    // 1. Many small jobs
+    // --------------------------------------------------------------------
+    std::printf("=== Step 1: 20000 jobs of ~1 us ===\n");
+    const int jobs = 20000;
+    double sum_async = 0, sum_pool = 0;
+    double t_async = ms([&] {
+        std::vector<std::future<double>> f;
+        for (int j = 0; j < jobs; ++j) f.push_back(std::async(std::launch::async, work, std::size_t(j % 64)));
+        for (auto& x : f) sum_async += x.get();
+    });
+    double t_pool = ms([&] {
+        std::vector<std::future<double>> f;
+        for (int j = 0; j < jobs; ++j) f.push_back(pool.submit([j] { return work(std::size_t(j % 64)); }));
+        for (auto& x : f) sum_pool += x.get();
+    });
+    std::printf("std::async (thread per job): %8.1f ms\n", t_async);
+    std::printf("pool.submit:                 %8.1f ms\n\n", t_pool);
+    ok = ok && sum_async == sum_pool;
+
+    // --------------------------------------------------------------------
+    // 2. Uneven loop
+    // --------------------------------------------------------------------
+    std::printf("=== Step 2: Loop with rising cost per iteration ===\n");
+    const std::size_t n = 20000;
+    std::vector<double> a(n), b(n);
+    double t_static = ms([&] {
+        std::vector<std::thread> pool_threads;
+        for (unsigned t = 0; t < threads; ++t)
+            pool_threads.emplace_back([&, t] {
+                for (std::size_t i = n * t / threads; i < n * (t + 1) / threads; ++i) a[i] = work(i);
+            });
+        for (auto& th : pool_threads) th.join();
+    });
+    const auto before = pool.stats();
+    double t_for = ms([&] { pool.parallel_for(0, n, [&](std::size_t i) { b[i] = work(i); }); });
+    const auto after = pool.stats();
+    std::printf("static slices, one thread each: %8.1f ms\n", t_static);
+    std::printf("parallel_for:                   %8.1f ms (%llu pieces run by workers, %llu stolen)\n\n", t_for,
+                static_cast<unsigned long long>(after.executed - before.executed),
+                static_cast<unsigned long long>(after.stolen - before.stolen));
+    ok = ok && a == b;
+
+    // --------------------------------------------------------------------
+    // 3. Nested tasks
+    // --------------------------------------------------------------------
+    std::printf("=== Step 3: fib(27) with nested submit() + wait() ===\n");
+    long f = 0;
+    double t_fib = ms([&] { f = fib(pool, 27); });
+    std::printf("fib(27) = %ld in %.1f ms\n\n", f, t_fib);
+    ok = ok && f == 196418;
+
+    // --------------------------------------------------------------------
+    // 4. Exceptions
+    // --------------------------------------------------------------------
+    std::printf("=== Step 4: An exception inside parallel_for ===\n");
+    try {
+        pool.parallel_for(0, 1000, [](std::size_t i) {
+            if (i == 777) throw std::runtime_error("bad element 777");
+        });
+        ok = false;
+    } catch (const std::exception& e) {
+        std::printf("caught: %s\n", e.what());
+    }
+
+    const auto s = pool.stats();
+    std::printf("\npool totals: %llu tasks, %llu stolen, workers parked %llu times\n",
+                static_cast<unsigned long long>(s.executed), static_cast<unsigned long long>(s.stolen),
+                static_cast<unsigned long long>(s.parked));
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,368 @@
+// work_stealing_pool.hpp
+// WorkStealingPool: a fixed set of worker threads that run submitted tasks
+// and parallel loops, balancing load by work stealing.
+//
+//   WorkStealingPool& pool = WorkStealingPool::shared();   // one per process
+//   std::future<int> f = pool.submit([] { return 6 * 7; });
+//   pool.parallel_for(0, v.size(), [&](std::size_t i) { v[i] = std::sqrt(v[i]); });
+//   pool.parallel_for(0, n, [&](std::size_t lo, std::size_t hi) { ... });   // whole ranges
+//   int x = pool.wait(f);   // like f.get(), but runs other tasks meanwhile
+//
+// Each worker owns a Chase-Lev deque. It pushes and pops tasks at the
+// bottom (newest first, still warm in its cache); idle workers steal from
+// the top of other deques (oldest first, which in a parallel_for is the
+// biggest piece). Threads that are not workers hand their tasks to a shared
+// queue. A worker that finds no work anywhere parks on a condition variable
+// until a task is posted.
+//
+// parallel_for splits its range lazily: a piece larger than the grain is
+// cut in two, the right half goes to the deque for thieves and the left
+// half is cut again, so with no idle thieves a loop costs a few pushes and
+// pops. The default grain gives about 8 pieces per worker. The caller runs
+// pieces too and returns when all are done; the first exception thrown by
+// the body is rethrown to the caller.
+//
+// Pitfalls:
+// - Inside a task, f.get() on another task's future blocks a worker; with
+//   every worker blocked that way the pool deadlocks. Use wait(f), which
+//   keeps running tasks until f is ready. parallel_for waits that way too,
+//   so it nests.
+// - Tasks should not block on I/O or locks for long: a blocked worker is a
+//   core the pool cannot use. Give blocking I/O its own thread (see
+//   IoThread in 11_file_os_interaction/external_sort.cpp); a task may then
+//   wait for that thread's futures with get(), since it never waits for
+//   the pool. Futures of pool tasks are waited for with wait(f) only.
+
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class WorkStealingPool {
+    struct Task {
+        virtual ~Task() = default;
+        virtual void run() = 0;
+    };
+    template <class F>
+    struct FnTask final : Task {
+        F f;
+        explicit FnTask(F&& fn) : f(std::move(fn)) {}
+        void run() override { f(); }
+    };
+
+    // Chase-Lev deque of Task* (Le, Pop, Cohen, Zappa Nardelli, PPoPP 2013).
+    // push/pop: owner thread only; steal: any thread.
+    class TaskDeque {
+        struct Ring {
+            std::size_t mask;
+            std::unique_ptr<std::atomic<Task*>[]> slot;
+            explicit Ring(std::size_t cap) : mask(cap - 1), slot(new std::atomic<Task*>[cap]) {}
+            Task* get(std::int64_t i) const { return slot[i & mask].load(std::memory_order_acquire); }
+            void put(std::int64_t i, Task* t) { slot[i & mask].store(t, std::memory_order_release); }
+        };
+        alignas(64) std::atomic<std::int64_t> top_{0};
+        alignas(64) std::atomic<std::int64_t> bottom_{0};
+        std::atomic<Ring*> ring_;
+        std::vector<std::unique_ptr<Ring>> rings_;  // thieves may still read an old ring: keep all
+
+    public:
+        TaskDeque() {
+            rings_.emplace_back(new Ring(1024));
+            ring_.store(rings_.back().get(), std::memory_order_relaxed);
+        }
+
+        void push(Task* t) {
+            const std::int64_t b = bottom_.load(std::memory_order_relaxed);
+            const std::int64_t top = top_.load(std::memory_order_acquire);
+            Ring* r = ring_.load(std::memory_order_relaxed);
+            if (b - top > static_cast<std::int64_t>(r->mask)) {  // full: double
+                rings_.emplace_back(new Ring(2 * (r->mask + 1)));
+                Ring* bigger = rings_.back().get();
+                for (std::int64_t i = top; i < b; ++i) bigger->put(i, r->get(i));
+                ring_.store(bigger, std::memory_order_release);
+                r = bigger;
+            }
+            r->put(b, t);
+            bottom_.store(b + 1, std::memory_order_release);
+        }
+
+        Task* pop() {
+            const std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            Ring* r = ring_.load(std::memory_order_relaxed);
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::int64_t top = top_.load(std::memory_order_relaxed);
+            if (top > b) {  // empty
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            Task* t = r->get(b);
+            if (top == b) {  // last one: race thieves for it
+                if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed))
+                    t = nullptr;
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+            return t;
+        }
+
+        Task* steal() {
+            std::int64_t top = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const std::int64_t b = bottom_.load(std::memory_order_acquire);
+            if (top >= b) return nullptr;
+            Task* t = ring_.load(std::memory_order_acquire)->get(top);
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return nullptr;  // lost the race; the caller tries elsewhere
+            return t;
+        }
+
+        bool empty() const {
+            return top_.load(std::memory_order_relaxed) >= bottom_.load(std::memory_order_relaxed);
+        }
+    };
+
+    struct alignas(64) Worker {
+        TaskDeque deque;
+        std::atomic<std::uint64_t> executed{0};
+        std::atomic<std::uint64_t> stolen{0};
+        std::thread thread;
+    };
+
+public:
+    struct Stats {
+        std::uint64_t executed = 0;  // tasks run by workers
+        std::uint64_t stolen = 0;    // of which taken from another worker's deque
+        std::uint64_t parked = 0;    // times a worker went to sleep
+    };
+
+    // threads == 0: one per hardware thread.
+    explicit WorkStealingPool(unsigned threads = 0) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        workers_.reserve(threads);
+        for (unsigned i = 0; i < threads; ++i) workers_.emplace_back(new Worker);
+        for (unsigned i = 0; i < threads; ++i) workers_[i]->thread = std::thread([this, i] { work(i); });
+    }
+
+    // Runs every task already submitted, then stops the workers.
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(park_m_);
+            stop_.store(true);
+        }
+        park_cv_.notify_all();
+        for (auto& w : workers_) w->thread.join();
+    }
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // The process-wide pool, sized to the machine. Parallel code in this
+    // repository runs here, so nested or concurrent users share the cores.
+    static WorkStealingPool& shared() {
+        static WorkStealingPool pool;
+        return pool;
+    }
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()); }
+
+    template <class F>
+    auto submit(F&& f) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using R = std::invoke_result_t<std::decay_t<F>>;
+        std::packaged_task<R()> task(std::forward<F>(f));
+        std::future<R> result = task.get_future();
+        post(new FnTask<std::packaged_task<R()>>(std::move(task)));
+        return result;
+    }
+
+    // Waits for f, running pool tasks meanwhile; safe inside a task.
+    template <class T>
+    T wait(std::future<T>& f) {
+        help_until([&] { return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready; });
+        return f.get();
+    }
+
+    // body(i) for every i in [begin, end), or body(lo, hi) for sub-ranges.
+    // grain == 0 picks about 8 pieces per worker.
+    template <class Body>
+    void parallel_for(std::size_t begin, std::size_t end, Body&& body, std::size_t grain = 0) {
+        if (begin >= end) return;
+        const std::size_t n = end - begin;
+        if (grain == 0) grain = std::max<std::size_t>(1, n / (8 * workers_.size()));
+        ForState<std::remove_reference_t<Body>> state{body, grain};
+        state.left.store(n, std::memory_order_relaxed);
+        run_range(state, begin, end);
+        help_until([&] { return state.left.load(std::memory_order_acquire) == 0; });
+        if (state.error) std::rethrow_exception(state.error);
+    }
+
+    Stats stats() const {
+        Stats s;
+        for (const auto& w : workers_) {
+            s.executed += w->executed.load(std::memory_order_relaxed);
+            s.stolen += w->stolen.load(std::memory_order_relaxed);
+        }
+        s.parked = parked_.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::mutex inject_m_;
+    std::deque<Task*> inject_;                    // tasks from non-worker threads
+    std::atomic<std::int64_t> pending_{0};        // queued, not yet taken
+    std::atomic<bool> stop_{false};
+    std::mutex park_m_;
+    std::condition_variable park_cv_;
+    std::atomic<unsigned> sleepers_{0};
+    std::atomic<std::uint64_t> parked_{0};
+
+    // Index of the calling thread among this pool's workers, or -1.
+    int self() const {
+        return tls_pool() == this ? tls_index() : -1;
+    }
+    static const WorkStealingPool*& tls_pool() {
+        thread_local const WorkStealingPool* pool = nullptr;
+        return pool;
+    }
+    static int& tls_index() {
+        thread_local int index = -1;
+        return index;
+    }
+
+    void post(Task* t) {
+        const int me = self();
+        if (me >= 0) {
+            workers_[me]->deque.push(t);
+        } else {
+            std::lock_guard<std::mutex> lock(inject_m_);
+            inject_.push_back(t);
+        }
+        // Paired with the sleepers_ increment in work(): either the parking
+        // worker sees the task, or we see the sleeper and wake it.
+        pending_.fetch_add(1);
+        if (sleepers_.load() > 0) {
+            std::lock_guard<std::mutex> lock(park_m_);
+            park_cv_.notify_one();
+        }
+    }
+
+    Task* find_task(int me) {
+        Task* t = nullptr;
+        if (me >= 0) t = workers_[me]->deque.pop();
+        if (t == nullptr && pending_.load(std::memory_order_relaxed) > 0) {
+            {
+                std::lock_guard<std::mutex> lock(inject_m_);
+                if (!inject_.empty()) {
+                    t = inject_.front();
+                    inject_.pop_front();
+                }
+            }
+            // Steal, starting after ourselves so that thieves spread out.
+            const std::size_t n = workers_.size();
+            const std::size_t start = me >= 0 ? static_cast<std::size_t>(me) + 1 : 0;
+            for (std::size_t i = 0; t == nullptr && i < n; ++i) {
+                const std::size_t victim = (start + i) % n;
+                if (static_cast<int>(victim) == me) continue;
+                t = workers_[victim]->deque.steal();
+                if (t != nullptr && me >= 0) workers_[me]->stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        if (t != nullptr) pending_.fetch_sub(1);
+        return t;
+    }
+
+    void execute(Task* t, int me) {
+        std::unique_ptr<Task> owned(t);
+        owned->run();
+        if (me >= 0) workers_[me]->executed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    template <class Pred>
+    void help_until(Pred done) {
+        const int me = self();
+        for (int idle = 0; !done();) {
+            if (Task* t = find_task(me)) {
+                execute(t, me);
+                idle = 0;
+            } else if (++idle < 64) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(std::chrono::microseconds(20));
+            }
+        }
+    }
+
+    void work(int me) {
+        tls_pool() = this;
+        tls_index() = me;
+        for (;;) {
+            Task* t = find_task(me);
+            for (int spin = 0; t == nullptr && spin < 32; ++spin) {
+                std::this_thread::yield();
+                t = find_task(me);
+            }
+            if (t != nullptr) {
+                execute(t, me);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(park_m_);
+            sleepers_.fetch_add(1);
+            if (pending_.load() <= 0 && !stop_.load()) {
+                parked_.fetch_add(1, std::memory_order_relaxed);
+                park_cv_.wait(lock, [&] { return pending_.load() > 0 || stop_.load(); });
+            }
+            sleepers_.fetch_sub(1);
+            if (stop_.load() && pending_.load() <= 0) return;
+        }
+    }
+
+    // ------------------------------------------------------------------
+    // parallel_for
+    // ------------------------------------------------------------------
+    template <class Body>
+    struct ForState {
+        Body& body;
+        std::size_t grain;
+        std::atomic<std::size_t> left{0};  // indices not yet done
+        std::mutex error_m;
+        std::exception_ptr error;
+        ForState(Body& b, std::size_t g) : body(b), grain(g) {}
+    };
+
+    template <class Body>
+    void run_range(ForState<Body>& s, std::size_t lo, std::size_t hi) {
+        while (hi - lo > s.grain) {  // hand the right half to thieves
+            const std::size_t mid = lo + (hi - lo) / 2;
+            auto right = [this, &s, mid, hi] { run_range(s, mid, hi); };
+            post(new FnTask<decltype(right)>(std::move(right)));
+            hi = mid;
+        }
+        try {
+            if constexpr (std::is_invocable_v<Body&, std::size_t, std::size_t>) {
+                s.body(lo, hi);
+            } else {
+                for (std::size_t i = lo; i < hi; ++i) s.body(i);
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(s.error_m);
+            if (!s.error) s.error = std::current_exception();
+        }
+        s.left.fetch_sub(hi - lo, std::memory_order_acq_rel);  // the last access to s
+    }
+};
+
+#endif // WORK_STEALING_POOL_HPP